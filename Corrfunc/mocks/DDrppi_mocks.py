@@ -22,7 +22,9 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
                  fast_divide=False, xbin_refine_factor=2,
                  ybin_refine_factor=2, zbin_refine_factor=1,
                  max_cells_per_dim=100,
-                 c_api_timer=False, isa=r'fastest', weight_type=None):
+                 c_api_timer=False, isa=r'fastest', weight_type=None,
+                 cell_ordering=r'rowmajor', use_kdtree=False, ngb_stencil=False,
+                 mixed_precision=False):
     """
     Calculate the 2-D pair-counts corresponding to the projected correlation
     function, :math:`\\xi(r_p, \pi)`. Pairs which are separated by less
@@ -171,6 +173,7 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
         suffer from numerical loss of precision and can not be trusted. If 
         you need accurate ``rpavg`` values, then pass in double precision 
         arrays for the particle positions.
+        Alternatively, set ``mixed_precision`` to sum the averages in double.
 
     fast_divide: boolean (default false)
         Boolean flag to replace the division in ``AVX`` implementation with an
@@ -192,7 +195,8 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
 
     isa: string (default ``fastest``)
         Controls the runtime dispatch for the instruction set to use. Possible
-        options are: [``fastest``, ``avx``, ``sse42``, ``fallback``]
+        options are: [``fastest``, ``avx512f``, ``avx``, ``sse42``,
+       ``fallback``]
 
         Setting isa to ``fastest`` will pick the fastest available instruction
         set on the current computer. However, if you set ``isa`` to, say,
@@ -205,6 +209,32 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
         benchmarking, then the string supplied here gets translated into an
         ``enum`` for the instruction set defined in ``utils/defs.h``.
         
+    cell_ordering: string (default ``rowmajor``)
+        Controls the order in which the cells of the lattice are stored in
+        memory and traversed. Possible options are: [``rowmajor``, ``morton``,
+        ``hilbert``]. The space-filling curve orderings (``morton`` and
+        ``hilbert``) keep neighbouring cells close in memory, and can improve
+        the runtime on large meshes. The results do not depend on the ordering.
+
+    use_kdtree: boolean (default false)
+        Replaces the lattice with a kd-tree, whose leaves are paired with a
+        dual-tree walk. Pairs of nodes that are farther apart than the largest
+        separation are discarded without visiting the particles. Can be faster
+        for strongly clustered points.
+
+    ngb_stencil: boolean (default false)
+        Finds the neighbouring cells on the fly from a stencil of cell offsets
+        that is shared by all the cells, instead of storing the list of
+        neighbour cells for every cell. Saves memory and setup time on large
+        meshes. The results are identical.
+
+    mixed_precision: boolean (default false)
+       Only used for float32 arrays. The pairs are still computed in
+       single precision, but the sums for ``rpavg`` and ``weightavg`` are
+       moved into double precision totals after every cell, so that the
+       averages match a double precision run (to ~1e-6) even for large
+       catalogs. The pair counts are not affected.
+
     weight_type: string, optional
         The type of weighting to apply.  One of ["pair_product", None].  Default: None.
 
@@ -315,7 +345,8 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
         raise ImportError(msg)
 
     import numpy as np
-    from Corrfunc.utils import translate_isa_string_to_enum, fix_ra_dec,\
+    from Corrfunc.utils import translate_isa_string_to_enum,\
+        translate_cell_ordering_string_to_enum, fix_ra_dec,\
         return_file_with_rbins
     from future.utils import bytes_to_native_str
     
@@ -354,6 +385,7 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
             kwargs[k] = v
 
     integer_isa = translate_isa_string_to_enum(isa)
+    integer_cell_ordering = translate_cell_ordering_string_to_enum(cell_ordering)
     rbinfile, delete_after_use = return_file_with_rbins(binfile)
     extn_results, api_time = DDrppi_extn(autocorr, cosmology, nthreads,
                                          pimax, rbinfile,
@@ -367,7 +399,11 @@ def DDrppi_mocks(autocorr, cosmology, nthreads, pimax, binfile,
                                          zbin_refine_factor=zbin_refine_factor,
                                          max_cells_per_dim=max_cells_per_dim,
                                          c_api_timer=c_api_timer,
-                                         isa=integer_isa, **kwargs)
+                                         isa=integer_isa,
+                                         cell_ordering=integer_cell_ordering,
+                                         use_kdtree=use_kdtree,
+                                         ngb_stencil=ngb_stencil,
+                                         mixed_precision=mixed_precision, **kwargs)
     if extn_results is None:
         msg = "RuntimeError occurred"
         raise RuntimeError(msg)
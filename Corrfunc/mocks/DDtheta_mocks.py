@@ -22,7 +22,9 @@ def DDtheta_mocks(autocorr, nthreads, binfile,
                   verbose=False, output_thetaavg=False,
                   fast_acos=False, ra_refine_factor=2,
                   dec_refine_factor=2, max_cells_per_dim=100,
-                  c_api_timer=False, isa=r'fastest', weight_type=None):
+                  c_api_timer=False, isa=r'fastest', weight_type=None,
+                  use_kdtree=False,
+                  mixed_precision=False):
     """
     Function to compute the angular correlation function for points on
     the sky (i.e., mock catalogs or observed galaxies).
@@ -129,6 +131,7 @@ def DDtheta_mocks(autocorr, nthreads, binfile,
        suffer from numerical loss of precision and can not be trusted. If you 
        need accurate ``thetaavg`` values, then pass in double precision arrays 
        for ``RA/DEC``.
+       Alternatively, set ``mixed_precision`` to sum the averages in double.
 
 
     .. note:: Code will run significantly slower if you enable this option.
@@ -169,7 +172,8 @@ def DDtheta_mocks(autocorr, nthreads, binfile,
 
     isa: string (default ``fastest``)
        Controls the runtime dispatch for the instruction set to use. Possible
-       options are: [``fastest``, ``avx``, ``sse42``, ``fallback``]
+       options are: [``fastest``, ``avx512f``, ``avx``, ``sse42``,
+       ``fallback``]
 
        Setting isa to ``fastest`` will pick the fastest available instruction
        set on the current computer. However, if you set ``isa`` to, say,
@@ -181,6 +185,19 @@ def DDtheta_mocks(autocorr, nthreads, binfile,
        benchmarking, then the string supplied here gets translated into an
        ``enum`` for the instruction set defined in ``utils/defs.h``.
 
+    use_kdtree: boolean (default false)
+       Replaces the declination (and RA) lattice with a kd-tree on the unit
+       sphere, whose leaves are paired with a dual-tree walk. Node pairs that
+       lie entirely within one angular bin are counted without visiting the
+       points. ``link_in_dec`` and ``link_in_ra`` are ignored.
+
+    mixed_precision: boolean (default false)
+       Only used for float32 arrays. The pairs are still computed in
+       single precision, but the sums for ``thetaavg`` and ``weightavg`` are
+       moved into double precision totals after every cell, so that the
+       averages match a double precision run (to ~1e-6) even for large
+       catalogs. The pair counts are not affected.
+
     Returns
     --------
 
@@ -313,7 +330,9 @@ def DDtheta_mocks(autocorr, nthreads, binfile,
                                                 dec_refine_factor=dec_refine_factor,
                                                 max_cells_per_dim=max_cells_per_dim,
                                                 c_api_timer=c_api_timer,
-                                                isa=integer_isa, **kwargs)
+                                                isa=integer_isa,
+                                                use_kdtree=use_kdtree,
+                                                mixed_precision=mixed_precision, **kwargs)
 
     if extn_results is None:
         msg = "RuntimeError occurred"
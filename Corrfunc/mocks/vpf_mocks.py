@@ -181,7 +181,8 @@ def vpf_mocks(rmax, nbins, nspheres, numpN,
 
     isa: string (default ``fastest``)
        Controls the runtime dispatch for the instruction set to use. Possible
-       options are: [``fastest``, ``avx``, ``sse42``, ``fallback``]
+       options are: [``fastest``, ``avx512f``, ``avx``, ``sse42``,
+       ``fallback``]
 
        Setting isa to ``fastest`` will pick the fastest available instruction
        set on the current computer. However, if you set ``isa`` to, say,
@@ -17,7 +17,9 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
        X2=None, Y2=None, Z2=None, weights2=None, verbose=False, boxsize=0.0,
        output_ravg=False, xbin_refine_factor=2, ybin_refine_factor=2,
        zbin_refine_factor=1, max_cells_per_dim=100,
-       c_api_timer=False, isa=r'fastest', weight_type=None):
+       c_api_timer=False, isa=r'fastest', weight_type=None,
+       cell_ordering=r'rowmajor', use_kdtree=False, ngb_stencil=False,
+       padded_cells=False, mixed_precision=False, autotune=False):
     """
     Calculate the 3-D pair-counts corresponding to the real-space correlation
     function, :math:`\\xi(r)`.
@@ -92,6 +94,7 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
        suffer from numerical loss of precision and can not be trusted. 
        If you need accurate ``ravg`` values, then pass in double precision 
        arrays for the particle positions.
+       Alternatively, set ``mixed_precision`` to sum the averages in double.
 
     (xyz)bin_refine_factor: integer, default is (2,2,1); typically within [1-3]
        Controls the refinement on the cell sizes. Can have up to a 20% impact
@@ -108,7 +111,8 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
 
     isa: string (default ``fastest``)
        Controls the runtime dispatch for the instruction set to use. Possible
-       options are: [``fastest``, ``avx``, ``sse42``, ``fallback``]
+       options are: [``fastest``, ``avx512f``, ``avx``, ``sse42``,
+       ``fallback``]
 
        Setting isa to ``fastest`` will pick the fastest available instruction
        set on the current computer. However, if you set ``isa`` to, say,
@@ -120,6 +124,48 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
        benchmarking, then the string supplied here gets translated into an
        ``enum`` for the instruction set defined in ``utils/defs.h``.
     
+    cell_ordering: string (default ``rowmajor``)
+       Controls the order in which the cells of the lattice are stored in
+       memory and traversed. Possible options are: [``rowmajor``, ``morton``,
+       ``hilbert``]. The space-filling curve orderings (``morton`` and
+       ``hilbert``) keep neighbouring cells close in memory, and can improve
+       the runtime on large meshes. The results do not depend on the ordering.
+
+    use_kdtree: boolean (default false)
+       Replaces the lattice with a kd-tree, whose leaves are paired with a
+       dual-tree walk. Node pairs that lie entirely within one bin are
+       counted without visiting the particles. Can be faster for strongly
+       clustered points. For periodic boundaries, the bins must be smaller
+       than half the ``boxsize``.
+
+    ngb_stencil: boolean (default false)
+       Finds the neighbouring cells on the fly from a stencil of cell offsets
+       that is shared by all the cells, instead of storing the list of
+       neighbour cells (and the periodic wraps) for every cell. Saves memory
+       and setup time on large meshes. The results are identical.
+
+    padded_cells: boolean (default false)
+       Pads the particles of every cell to a multiple of 64 bytes (with
+       sentinel positions that never pair) and aligns every cell to a cache
+       line. The kernels are the same as for packed cells, and the pair
+       counts are identical.
+
+    mixed_precision: boolean (default false)
+       Only used for float32 arrays. The pairs are still computed in
+       single precision, but the sums for ``ravg`` and ``weightavg`` are
+       moved into double precision totals after every cell, so that the
+       averages match a double precision run (to ~1e-6) even for large
+       catalogs. The pair counts are not affected.
+
+    autotune: boolean (default false)
+       Only used with the default bin refine factors. The first call on this
+       machine (for this statistic, and roughly this N and rmax/boxsize)
+       times the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a
+       subsample of the particles, and caches the fastest in the file named
+       by the ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (default:
+       ``~/.corrfunc_autotune``). Later calls read the cached settings.
+       See also :py:func:`Corrfunc.utils.find_fastest_wp_bin_refs`.
+
     weight_type: string, optional
         The type of weighting to apply.  One of ["pair_product", None].  Default: None.
 
@@ -186,6 +232,7 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
 
     import numpy as np
     from Corrfunc.utils import translate_isa_string_to_enum,\
+        translate_cell_ordering_string_to_enum,\
         return_file_with_rbins
     from future.utils import bytes_to_native_str
     
@@ -215,6 +262,7 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
             kwargs[k] = v
 
     integer_isa = translate_isa_string_to_enum(isa)
+    integer_cell_ordering = translate_cell_ordering_string_to_enum(cell_ordering)
     rbinfile, delete_after_use = return_file_with_rbins(binfile)
     extn_results, api_time = DD_extn(autocorr, nthreads, rbinfile,
                                      X1, Y1, Z1,
@@ -227,7 +275,14 @@ def DD(autocorr, nthreads, binfile, X1, Y1, Z1, weights1=None, periodic=True,
                                      zbin_refine_factor=zbin_refine_factor,
                                      max_cells_per_dim=max_cells_per_dim,
                                      c_api_timer=c_api_timer,
-                                     isa=integer_isa, **kwargs)
+                                     isa=integer_isa,
+                                     cell_ordering=integer_cell_ordering,
+                                     use_kdtree=use_kdtree,
+                                     ngb_stencil=ngb_stencil,
+                                     padded_cells=padded_cells,
+                                     mixed_precision=mixed_precision,
+                                     autotune=autotune,
+                                     **kwargs)
     if extn_results is None:
         msg = "RuntimeError occurred"
         raise RuntimeError(msg)
@@ -19,7 +19,9 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
        weights=None, weight_type=None, verbose=False, output_ravg=False,
        xbin_refine_factor=2, ybin_refine_factor=2,
        zbin_refine_factor=1, max_cells_per_dim=100,
-       c_api_timer=False, isa=r'fastest'):
+       c_api_timer=False, isa=r'fastest',
+       cell_ordering=r'rowmajor', ngb_stencil=False,
+       mixed_precision=False, autotune=False):
     """
     Function to compute the projected correlation function in a
     periodic cosmological box. Pairs which are separated by less
@@ -83,6 +85,7 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
         suffer from numerical loss of precision and can not be trusted. If 
         you need accurate ``rpavg`` values, then pass in double precision 
         arrays for the particle positions.
+        Alternatively, set ``mixed_precision`` to sum the averages in double.
 
     (xyz)bin_refine_factor: integer, default is (2,2,1); typically within [1-3]
        Controls the refinement on the cell sizes. Can have up to a 20% impact
@@ -99,7 +102,8 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
 
     isa: string (default ``fastest``)
        Controls the runtime dispatch for the instruction set to use. Possible
-       options are: [``fastest``, ``avx``, ``sse42``, ``fallback``]
+       options are: [``fastest``, ``avx512f``, ``avx``, ``sse42``,
+       ``fallback``]
 
        Setting isa to ``fastest`` will pick the fastest available instruction
        set on the current computer. However, if you set ``isa`` to, say,
@@ -111,6 +115,35 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
        benchmarking, then the string supplied here gets translated into an
        ``enum`` for the instruction set defined in ``utils/defs.h``.
        
+    cell_ordering: string (default ``rowmajor``)
+       Controls the order in which the cells of the lattice are stored in
+       memory and traversed. Possible options are: [``rowmajor``, ``morton``,
+       ``hilbert``]. The space-filling curve orderings (``morton`` and
+       ``hilbert``) keep neighbouring cells close in memory, and can improve
+       the runtime on large meshes. The results do not depend on the ordering.
+
+    ngb_stencil: boolean (default false)
+       Finds the neighbouring cells on the fly from a stencil of cell offsets
+       that is shared by all the cells, instead of storing the list of
+       neighbour cells (and the periodic wraps) for every cell. Saves memory
+       and setup time on large meshes. The results are identical.
+
+    mixed_precision: boolean (default false)
+       Only used for float32 arrays. The pairs are still computed in
+       single precision, but the sums for ``ravg`` and ``weightavg`` are
+       moved into double precision totals after every cell, so that the
+       averages match a double precision run (to ~1e-6) even for large
+       catalogs. The pair counts are not affected.
+
+    autotune: boolean (default false)
+       Only used with the default bin refine factors. The first call on this
+       machine (for this statistic, and roughly this N and rmax/boxsize)
+       times the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a
+       subsample of the particles, and caches the fastest in the file named
+       by the ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (default:
+       ``~/.corrfunc_autotune``). Later calls read the cached settings.
+       See also :py:func:`Corrfunc.utils.find_fastest_wp_bin_refs`.
+
     weight_type: string, optional, Default: None.
         The type of weighting to apply.  One of ["pair_product", None].  
 
@@ -181,6 +214,7 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
     import numpy as np
     from future.utils import bytes_to_native_str
     from Corrfunc.utils import translate_isa_string_to_enum,\
+        translate_cell_ordering_string_to_enum,\
         return_file_with_rbins
         
     # Broadcast scalar weights to arrays
@@ -195,6 +229,7 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
             kwargs[k] = v
 
     integer_isa = translate_isa_string_to_enum(isa)
+    integer_cell_ordering = translate_cell_ordering_string_to_enum(cell_ordering)
     rbinfile, delete_after_use = return_file_with_rbins(binfile)
     extn_results, api_time = xi_extn(boxsize, nthreads, rbinfile,
                                      X, Y, Z,
@@ -205,7 +240,11 @@ def xi(boxsize, nthreads, binfile, X, Y, Z,
                                      zbin_refine_factor=zbin_refine_factor,
                                      max_cells_per_dim=max_cells_per_dim,
                                      c_api_timer=c_api_timer,
-                                     isa=integer_isa, **kwargs)
+                                     isa=integer_isa,
+                                     cell_ordering=integer_cell_ordering,
+                                     ngb_stencil=ngb_stencil,
+                                     mixed_precision=mixed_precision,
+                                     autotune=autotune, **kwargs)
     if extn_results is None:
         msg = "RuntimeError occurred"
         raise RuntimeError(msg)
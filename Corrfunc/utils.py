@@ -464,14 +464,14 @@ def translate_isa_string_to_enum(isa):
     """
     Helper function to convert an user-supplied string to the
     underlying enum in the C-API. The extensions only have specific
-    implementations for AVX, SSE42 and FALLBACK. Any other value
+    implementations for AVX512F, AVX, SSE42 and FALLBACK. Any other value
     will raise a ValueError.
 
     Parameters
     ------------
     isa: string
        A string containing the desired instruction set. Valid values are
-       ['AVX', 'SSE42', 'FALLBACK', 'FASTEST']
+       ['AVX512F', 'AVX', 'SSE42', 'FALLBACK', 'FASTEST']
 
     Returns
     --------
@@ -490,7 +490,7 @@ def translate_isa_string_to_enum(isa):
     except NameError:
         if not isinstance(isa, str):
             raise TypeError(msg)
-    valid_isa = ['FALLBACK', 'AVX', 'SSE42', 'FASTEST']
+    valid_isa = ['FALLBACK', 'AVX', 'SSE42', 'AVX512F', 'FASTEST']
     isa_upper = isa.upper()
     if isa_upper not in valid_isa:
         msg = "Desired instruction set = {0} is not in the list of valid "\
@@ -517,6 +517,49 @@ def translate_isa_string_to_enum(isa):
         raise
 
 
+def translate_cell_ordering_string_to_enum(cell_ordering):
+    """
+    Helper function to convert an user-supplied string to the
+    underlying value for the cell ordering in the C-API. Any value other
+    than ['ROWMAJOR', 'MORTON', 'HILBERT'] will raise a ValueError.
+
+    Parameters
+    ------------
+    cell_ordering: string
+       A string containing the desired ordering of the cells. Valid values
+       are ['ROWMAJOR', 'MORTON', 'HILBERT']
+
+    Returns
+    --------
+    ordering: integer
+       An integer corresponding to the desired ordering, as used in the
+       underlying C API. The values used here should be defined *exactly*
+       the same way as the ``BINNING_ORD_*`` macros in ``utils/defs.h``.
+
+    """
+
+    msg = "Input to translate_cell_ordering_string_to_enum must be "\
+          "of string type. Found type = {0}".format(type(cell_ordering))
+    try:
+        if not isinstance(cell_ordering, str):
+            raise TypeError(msg)
+    except NameError:
+        if not isinstance(cell_ordering, str):
+            raise TypeError(msg)
+
+    enums = {'ROWMAJOR': 0,
+             'MORTON': 1,
+             'HILBERT': 2
+             }
+    ordering_upper = cell_ordering.upper()
+    if ordering_upper not in enums:
+        msg = "Desired cell ordering = {0} is not in the list of valid "\
+              "orderings = {1}".format(cell_ordering, list(enums.keys()))
+        raise ValueError(msg)
+
+    return enums[ordering_upper]
+
+
 def compute_nbins(max_diff, binsize,
                  refine_factor=1,
                  max_nbins=None):
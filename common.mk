@@ -236,13 +236,17 @@ ifeq ($(DO_CHECKS), 1)
   ## Check for conflicting options
   ifeq (OUTPUT_RPAVG,$(findstring OUTPUT_RPAVG,$(OPT)))
     ifneq (DOUBLE_PREC,$(findstring DOUBLE_PREC,$(OPT)))
-      $(error $(ccred) DOUBLE_PREC must be enabled with OUTPUT_RPAVG -- loss of precision will give you incorrect results for the outer bins (>=20-30 million pairs) $(ccreset))
+      ifneq (MIXED_PREC,$(findstring MIXED_PREC,$(OPT)))
+        $(error $(ccred) DOUBLE_PREC (or MIXED_PREC) must be enabled with OUTPUT_RPAVG -- loss of precision will give you incorrect results for the outer bins (>=20-30 million pairs) $(ccreset))
+      endif
     endif
   endif
 
   ifeq (OUTPUT_THETAAVG,$(findstring OUTPUT_THETAAVG,$(OPT)))
     ifneq (DOUBLE_PREC,$(findstring DOUBLE_PREC,$(OPT)))
-      $(error $(ccred) DOUBLE_PREC must be enabled with OUTPUT_THETAAVG -- loss of precision will give you incorrect results for the outer bins (>=20-30 million pairs) $(ccreset))
+      ifneq (MIXED_PREC,$(findstring MIXED_PREC,$(OPT)))
+        $(error $(ccred) DOUBLE_PREC (or MIXED_PREC) must be enabled with OUTPUT_THETAAVG -- loss of precision will give you incorrect results for the outer bins (>=20-30 million pairs) $(ccreset))
+      endif
     endif
   endif
 
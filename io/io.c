@@ -26,6 +26,46 @@
 #define MAXLEN 500
 #endif
 
+/* If the file does not exist but the gzipped file does, uncompress it in-place. *ALL* file open calls
+   here are to fopen and *NOT* my_fopen */
+static int uncompress_if_gzipped(const char *filename)
+{
+    FILE *fp = fopen(filename,"r");
+    if(fp == NULL) {
+        /* file does not exist. let's see if the filename.gz file does */
+        char buf[MAXLEN] = "";
+        my_snprintf(buf, MAXLEN,"%s.gz",filename);
+        fp = fopen(buf,"r");
+        if (fp == NULL) {
+            /* well then, file not found*/
+            fprintf(stderr,"ERROR: Could not find file: neither as `%s' nor as `%s'\n",filename,buf);
+            return EXIT_FAILURE;
+        } else {
+            /* found the gzipped file. Use a system call to uncompress. */
+            fclose(fp);
+
+            /*
+              Note, I am using `filename` rather than `buf` both
+              because C standards say that using the same buffer
+              as both source and destination is *undefined behaviour*.
+
+              Check under "NOTES", towards the end of "man 3 snprintf".
+            */
+            my_snprintf(buf,MAXLEN,"gunzip %s.gz",filename);
+            fprintf(stderr,ANSI_COLOR_YELLOW "Could not locate `%s' but found the gzip file `%s.gz'.\nRunning system command `" ANSI_COLOR_BLUE "%s"ANSI_COLOR_YELLOW"' now to uncompress"ANSI_COLOR_RESET "\n",filename,filename,buf);
+            int status = run_system_call(buf);
+            if(status != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+    } else {
+        //file exists -> nothing to do.
+        fclose(fp);
+    }
+    return EXIT_SUCCESS;
+}
+
+
 int64_t read_positions(const char *filename, const char *format, const size_t size, const int num_fields, ...)
 {
     XRETURN((sizeof(void *) == sizeof(float *) && sizeof(void *) == sizeof(double *)), -1,
@@ -53,47 +93,10 @@ int64_t read_columns_into_array(const char *filename, const char *format, const
     XRETURN(num_fields >= 1, -1, "Number of fields to read-in = %d must be at least 1\n", num_fields);
     XRETURN((size == 4 || size == 8), -1, "Size of fields = %zu must be either 4 or 8\n", size);
     
-    {
-        //new scope - just to check if file is gzipped.
-        //in that case, use gunzip to unzip the file.
-        // *ALL* file open calls in this scope
-        // are to fopen and *NOT* my_fopen.
-
-        FILE *fp = fopen(filename,"r");
-        if(fp == NULL) {
-            /* file does not exist. let's see if the filename.gz file does */
-            char buf[MAXLEN] = "";
-            my_snprintf(buf, MAXLEN,"%s.gz",filename);
-            fp = fopen(buf,"r");
-            if (fp == NULL) {
-                /* well then, file not found*/
-                fprintf(stderr,"ERROR: Could not find file: neither as `%s' nor as `%s'\n",filename,buf);
-                return -1;
-            } else {
-                /* found the gzipped file. Use a system call to uncompress. */
-                fclose(fp);
-
-                /*
-                  Note, I am using `filename` rather than `buf` both
-                  because C standards say that using the same buffer
-                  as both source and destination is *undefined behaviour*.
-
-                  Check under "NOTES", towards the end of "man 3 snprintf".
-                */
-                my_snprintf(buf,MAXLEN,"gunzip %s.gz",filename);
-                fprintf(stderr,ANSI_COLOR_YELLOW "Could not locate `%s' but found the gzip file `%s.gz'.\nRunning system command `" ANSI_COLOR_BLUE "%s"ANSI_COLOR_YELLOW"' now to uncompress"ANSI_COLOR_RESET "\n",filename,filename,buf);
-                int status = run_system_call(buf);
-                if(status != EXIT_SUCCESS) {
-                    return -1;
-                }
-            }
-        } else {
-            //file exists -> nothing to do.
-            fclose(fp);
-        }
+    if(uncompress_if_gzipped(filename) != EXIT_SUCCESS) {
+        return -1;
     }
 
-
     if(strncmp(format,"f",1)==0) { /*Read-in fast-food file*/
         //read fast-food file
         int idat[5];
@@ -282,3 +285,236 @@ int64_t read_columns_into_array(const char *filename, const char *format, const
     
     return np;
 }
+
+
+/* Columns of a file that are read on demand (for open_particle_source) */
+typedef struct{
+    FILE *fp;
+    int fast_food;
+    int num_fields;
+    int64_t np;
+    /* fast-food: precision in the file, and the location of the first value of the first column */
+    size_t file_size;
+    long offset;
+    void *buffer;
+    int64_t buffer_np;
+    /* ascii: the index of the particle in the next valid line */
+    int64_t next;
+} column_stream;
+
+static void close_column_stream(column_stream *stream)
+{
+    if(stream->fp != NULL) {
+        fclose(stream->fp);
+    }
+    free(stream->buffer);
+    stream->fp = NULL;
+    stream->buffer = NULL;
+}
+
+/* Parses the first `num_fields' columns of an ascii line. Returns 1 if all the fields could be parsed */
+static int parse_ascii_line(char *buffer, const int num_fields, double *values)
+{
+    char delimiters[]=" ,\t";//delimiters are white-space, comma and tab
+    char *saveptr, *copy=buffer;
+    for(int j=0;j<num_fields;j++,copy=NULL) {
+        const char *token = strtok_r(copy,delimiters,&saveptr);
+        if(token == NULL || sscanf(token,"%lf",&values[j]) != 1) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int open_column_stream(column_stream *stream, const char *filename, const char *format, const int num_fields)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->num_fields = num_fields;
+    if(uncompress_if_gzipped(filename) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    stream->fp = my_fopen(filename,"r");
+    if(stream->fp == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    if(strncmp(format,"f",1)==0) {
+        stream->fast_food = 1;
+        int idat[5];
+        float fdat[9];
+        size_t bytes=sizeof(int) + sizeof(fdat) + sizeof(int);//skip fdat
+        bytes += sizeof(int) + sizeof(float) + sizeof(int); //skip znow
+        if(my_ftread(idat,sizeof(idat[0]),5,stream->fp) != EXIT_SUCCESS) {
+            close_column_stream(stream);
+            return EXIT_FAILURE;
+        }
+        stream->np = (int64_t) idat[1]; //idat[1] is int.
+        my_fseek(stream->fp,bytes,SEEK_CUR);
+        unsigned int dummy;
+        my_fread(&dummy,sizeof(dummy), 1, stream->fp);
+        if(stream->np <= 0 || ! (dummy/stream->np == 4 || dummy/stream->np == 8)) {
+            fprintf(stderr,"ERROR: In %s> Data-type in file `%s' must be either 4 byte (float) or 8 byte(double) precision\n", __FUNCTION__, filename);
+            close_column_stream(stream);
+            return EXIT_FAILURE;
+        }
+        stream->file_size = dummy/stream->np;
+        stream->offset = ftell(stream->fp);
+    } else if(strncmp(format,"a",1)==0 || strncmp(format,"c",1)==0) {
+        /* Count the lines that can be parsed */
+        const int MAXBUFSIZE=10000;
+        char buffer[MAXBUFSIZE];
+        double values[num_fields];
+        while(fgets(buffer,MAXBUFSIZE,stream->fp) != NULL) {
+            stream->np += parse_ascii_line(buffer, num_fields, values);
+        }
+        rewind(stream->fp);
+    } else {
+        fprintf(stderr,"ERROR: In %s> Unknown format `%s'\n",__FUNCTION__,format);
+        close_column_stream(stream);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* Reads the particles [start, start + n) of every column into data[] (with `size' bytes per value) */
+static int read_column_stream(column_stream *stream, const int64_t start, const int64_t n, const size_t size, void **data)
+{
+    if(stream->fast_food) {
+        void *dst = NULL;
+        if(stream->file_size != size) {
+            if(stream->buffer_np < n) {
+                free(stream->buffer);
+                stream->buffer = my_malloc(stream->file_size, n);
+                if(stream->buffer == NULL) {
+                    stream->buffer_np = 0;
+                    return EXIT_FAILURE;
+                }
+                stream->buffer_np = n;
+            }
+            dst = stream->buffer;
+        }
+        /* Every column is a fortran record of np values with a 4 byte marker on either side */
+        const long record_bytes = (long) (stream->np * stream->file_size + 2*sizeof(int));
+        for(int i=0;i<stream->num_fields;i++) {
+            void *values = (dst == NULL) ? data[i]:dst;
+            if(my_fseek(stream->fp, stream->offset + i*record_bytes + start*(long) stream->file_size, SEEK_SET) != 0 ||
+               my_fread(values, stream->file_size, n, stream->fp) != (size_t) n) {
+                return EXIT_FAILURE;
+            }
+            if(dst == NULL) continue;
+            if(size == 8) {
+                const float *src = (const float *) dst;
+                double *tmp_pos = (double *) data[i];
+                for(int64_t j=0;j<n;j++) tmp_pos[j] = src[j];
+            } else {
+                const double *src = (const double *) dst;
+                float *tmp_pos = (float *) data[i];
+                for(int64_t j=0;j<n;j++) tmp_pos[j] = src[j];
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /* ascii files can only be read sequentially -> start over if the requested particles have already been read */
+    if(start < stream->next) {
+        rewind(stream->fp);
+        stream->next = 0;
+    }
+    const int MAXBUFSIZE=10000;
+    char buffer[MAXBUFSIZE];
+    double values[stream->num_fields];
+    int64_t i = 0;
+    while(i < n && fgets(buffer,MAXBUFSIZE,stream->fp) != NULL) {
+        if(parse_ascii_line(buffer, stream->num_fields, values) == 0) {
+            continue;
+        }
+        stream->next++;
+        if(stream->next <= start) {
+            continue;
+        }
+        for(int j=0;j<stream->num_fields;j++) {
+            if(size==4) {
+                ((float *) data[j])[i] = values[j];
+            } else {
+                ((double *) data[j])[i] = values[j];
+            }
+        }
+        i++;
+    }
+    if(i != n) {
+        fprintf(stderr,"ERROR: In %s> Could only read %"PRId64" particles out of the requested %"PRId64" (starting at particle %"PRId64")\n",
+                __FUNCTION__, i, n, start);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+typedef struct{
+    size_t size;
+    column_stream positions;
+    column_stream weights;
+} particle_file_stream;
+
+static void close_particle_file_stream(particle_source *source)
+{
+    particle_file_stream *files = (particle_file_stream *) source->state;
+    if(files == NULL) return;
+    close_column_stream(&(files->positions));
+    close_column_stream(&(files->weights));
+    free(files);
+}
+
+static int read_particle_file_stream(particle_source *source, const int64_t start, const int64_t n,
+                                     void *x, void *y, void *z, void **weights)
+{
+    particle_file_stream *files = (particle_file_stream *) source->state;
+    void *xyz[] = {x, y, z};
+    if(read_column_stream(&(files->positions), start, n, files->size, xyz) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if(source->num_weights > 0) {
+        return read_column_stream(&(files->weights), start, n, files->size, weights);
+    }
+    return EXIT_SUCCESS;
+}
+
+int open_particle_source(particle_source *source, const char *filename, const char *format,
+                         const char *weights_filename, const char *weights_format, const int num_weights,
+                         const size_t size)
+{
+    XRETURN((size == 4 || size == 8), EXIT_FAILURE, "Size of fields = %zu must be either 4 or 8\n", size);
+    XRETURN(num_weights >= 0 && num_weights <= MAX_NUM_WEIGHTS, EXIT_FAILURE,
+            "Number of weights = %d must be within [0, %d]\n", num_weights, MAX_NUM_WEIGHTS);
+    memset(source, 0, sizeof(*source));
+    particle_file_stream *files = my_calloc(sizeof(*files), 1);
+    if(files == NULL) {
+        return EXIT_FAILURE;
+    }
+    files->size = size;
+    source->state = files;
+    source->close = close_particle_file_stream;
+    source->read = read_particle_file_stream;
+    source->float_type = size;
+    source->num_weights = num_weights;
+
+    if(open_column_stream(&(files->positions), filename, format, 3) != EXIT_SUCCESS) {
+        close_particle_source(source);
+        return EXIT_FAILURE;
+    }
+    source->np = files->positions.np;
+    if(num_weights > 0) {
+        if(open_column_stream(&(files->weights), weights_filename, weights_format, num_weights) != EXIT_SUCCESS) {
+            close_particle_source(source);
+            return EXIT_FAILURE;
+        }
+        if(files->weights.np != source->np) {
+            fprintf(stderr,"ERROR: In %s> Number of weights = %"PRId64" in `%s' does not match the number of particles = %"PRId64" in `%s'\n",
+                    __FUNCTION__, files->weights.np, weights_filename, source->np, filename);
+            close_particle_source(source);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
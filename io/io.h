@@ -8,6 +8,7 @@
 
 #pragma once
 #include <stdio.h>
+#include "particle_source.h"//for particle_source
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,6 +17,12 @@ extern "C" {
     int64_t read_positions(const char *filename, const char *format, const size_t size, const int num_fields, ...) __attribute__((warn_unused_result));
     int64_t read_columns_into_array(const char *filename, const char *format, const size_t size, const int num_fields, void **data) __attribute__((warn_unused_result));
 
+    /* Streams the positions (and the `num_weights' weights, if any) from the files, instead of reading them into memory.
+       The files have the same formats as for read_positions. Close with close_particle_source */
+    int open_particle_source(particle_source *source, const char *filename, const char *format,
+                             const char *weights_filename, const char *weights_format, const int num_weights,
+                             const size_t size) __attribute__((warn_unused_result));
+
 #ifdef __cplusplus
 }
 #endif
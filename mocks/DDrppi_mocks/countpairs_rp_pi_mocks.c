@@ -23,6 +23,7 @@ void free_results_mocks(results_countpairs_mocks *results)
     free(results->rupp);
     free(results->rpavg);
     free(results->weightavg);
+    free(results->region_npairs);
 }
 
 
@@ -71,3 +72,39 @@ int countpairs_mocks(const int64_t ND1, void *phi1, void *theta1, void *czD1,
                                        extra);
     }
 }
+
+
+int countpairs_mocks_dd_dr_rr(const int64_t ND, void *ra, void *dec, void *czD,
+                              const int64_t NR, void *ra_r, void *dec_r, void *czR,
+                              const int numthreads,
+                              const char *binfile,
+                              const double pimax,
+                              const int cosmology,
+                              results_countpairs_mocks *dd, results_countpairs_mocks *dr, results_countpairs_mocks *rr,
+                              struct config_options *options, struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_mocks_dd_dr_rr_float(ND, (float *) ra, (float *) dec, (float *) czD,
+                                               NR, (float *) ra_r, (float *) dec_r, (float *) czR,
+                                               numthreads, binfile, pimax, cosmology,
+                                               dd, dr, rr,
+                                               options, extra);
+    } else {
+        return countpairs_mocks_dd_dr_rr_double(ND, (double *) ra, (double *) dec, (double *) czD,
+                                                NR, (double *) ra_r, (double *) dec_r, (double *) czR,
+                                                numthreads, binfile, pimax, cosmology,
+                                                dd, dr, rr,
+                                                options, extra);
+    }
+}
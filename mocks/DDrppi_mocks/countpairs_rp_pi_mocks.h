@@ -21,7 +21,9 @@ extern "C" {
         double *rupp;
         double *rpavg;
         double *weightavg;
+        uint64_t *region_npairs;/* pair counts for every pair of region labels (see region_labels.h). NULL without labels */
         double pimax;
+        int nregions;
         int nbin;
         int npibin;
     } results_countpairs_mocks;
@@ -36,6 +38,20 @@ extern "C" {
                          results_countpairs_mocks *results,
                          struct config_options *options, struct extra_options *extra);
 
+    /* DD, DR and RR from one lattice of cells (shared by the data and the randoms) and a single walk over the pairs of
+       neighbouring cells. The data weights are in extra->weights0 and the weights of the randoms in extra->weights1. DD and
+       RR are autocorrelations and DR is the cross-correlation of the data with the randoms. The cz of the data and the
+       randoms are converted to co-moving distances with the same interpolation table. Region labels and the kd-tree are
+       not supported */
+    int countpairs_mocks_dd_dr_rr(const int64_t ND, void *ra, void *dec, void *czD,
+                                  const int64_t NR, void *ra_r, void *dec_r, void *czR,
+                                  const int numthreads,
+                                  const char *binfile,
+                                  const double pimax,
+                                  const int cosmology,
+                                  results_countpairs_mocks *dd, results_countpairs_mocks *dr, results_countpairs_mocks *rr,
+                                  struct config_options *options, struct extra_options *extra);
+
     void free_results_mocks(results_countpairs_mocks *results);
 
 #ifdef __cplusplus
@@ -23,6 +23,7 @@ void free_results_countpairs_theta(results_countpairs_theta *results)
     free(results->npairs);
     free(results->theta_avg);
     free(results->weightavg);
+    free(results->region_npairs);
 }
 
 
@@ -21,6 +21,8 @@ extern "C" {
         double *theta_upp;
         double *theta_avg;
         double *weightavg;
+        uint64_t *region_npairs;/* pair counts for every pair of region labels (see region_labels.h). NULL without labels */
+        int nregions;
         int nbin;
     } results_countpairs_theta;
 
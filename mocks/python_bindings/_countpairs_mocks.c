@@ -76,7 +76,8 @@ static PyMethodDef module_methods[] = {
      "                       fast_divide=False, xbin_refine_factor=2, \n"
      "                       ybin_refine_factor=2, zbin_refine_factor=1, \n"
      "                       max_cells_per_dim=100, \n"
-     "                       c_api_timer=False, isa=-1)\n"
+     "                       c_api_timer=False, isa=-1, cell_ordering=0, use_kdtree=False,\n"
+     "                       ngb_stencil=False, mixed_precision=False)\n"
      "\n"
      "Calculate the 2-D pair-counts, "XI_CHAR"("RP_CHAR", "PI_CHAR"), auto/cross-correlation function given two\n"
      "sets of RA1/DEC1/CZ1 and RA2/DEC2/CZ2 arrays. This module is suitable for mock catalogs that have been\n"
@@ -204,6 +205,23 @@ static PyMethodDef module_methods[] = {
      "  then the integer values correspond to the ``enum`` for the instruction set\n"
      "  defined in ``utils/defs.h``.\n"
      "\n"
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "use_kdtree : boolean (default false)\n"
+     "  Replaces the lattice with a kd-tree, whose leaves are paired with a\n"
+     "  dual-tree walk. Faster for strongly clustered points.\n\n"
+     "ngb_stencil : boolean (default false)\n"
+     "  Finds the neighbouring cells from a stencil of cell offsets shared by\n"
+     "  all the cells, instead of storing the neighbour cells for every cell.\n"
+     "  Saves memory and setup time on large meshes; the results are identical.\n\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (rpavg, weightavg) are moved into double totals\n"
+     "  after every cell. The pair counts are not affected.\n\n"
      "Returns\n"
      "--------\n"
      "\n"
@@ -242,7 +260,8 @@ static PyMethodDef module_methods[] = {
      "                       verbose=False, output_thetaavg=False,\n"
      "                       fast_acos=False, ra_refine_factor=2,\n"
      "                       dec_refine_factor=2, max_cells_per_dim=100, \n"
-     "                       c_api_timer=False, isa='fastest')\n"
+     "                       c_api_timer=False, isa='fastest', use_kdtree=False,\n"
+     "                       mixed_precision=False)\n"
      "\n"
      "Calculate the angular pair-counts, required for "OMEGA_CHAR"("THETA_CHAR"), auto/cross-correlation function given two\n"
      "sets of RA1/DEC1 and RA2/DEC2 arrays. This module is suitable for mock catalogs that have been\n"
@@ -350,6 +369,16 @@ static PyMethodDef module_methods[] = {
      "  then the integer values correspond to the ``enum`` for the instruction set\n"
      "  defined in ``utils/defs.h``.\n"
      "\n"
+     "use_kdtree : boolean (default false)\n"
+     "  Replaces the declination (and RA) lattice with a kd-tree on the unit\n"
+     "  sphere, whose leaves are paired with a dual-tree walk. ``link_in_dec``\n"
+     "  and ``link_in_ra`` are ignored.\n"
+     "\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (thetaavg, weightavg) are moved into double totals\n"
+     "  after every cell. The pair counts are not affected.\n"
+     "\n"
      "Returns\n"
      "--------\n"
      "A tuple (results, time) \n"
@@ -909,6 +938,8 @@ static PyObject *countpairs_countpairs_rp_pi_mocks(PyObject *self, PyObject *arg
     int8_t xbin_ref=options.bin_refine_factors[0],
         ybin_ref=options.bin_refine_factors[1],
         zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+    int8_t ngb_stencil=(get_ngb_scheme(&options) == BINNING_NGB_STENCIL);
 
     int autocorr=1;
     int nthreads=4;
@@ -941,10 +972,14 @@ static PyObject *countpairs_countpairs_rp_pi_mocks(PyObject *self, PyObject *arg
         "c_api_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK (enum) */
         "weight_type",
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        "use_kdtree",/* pair the leaves of a kd-tree instead of the cells of the lattice */
+        "ngb_stencil",/* find the neighbouring cells from a stencil shared by all cells, instead of storing them per cell */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
         NULL
     };
 
-    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iiidsO!O!O!|O!O!O!O!O!bbbbbbbhbis", kwlist,
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iiidsO!O!O!|O!O!O!O!O!bbbbbbbhbisbbbb", kwlist,
                                        &autocorr,&cosmology,&nthreads,&pimax,&binfile,
                                        &PyArray_Type,&x1_obj,
                                        &PyArray_Type,&y1_obj,
@@ -962,7 +997,11 @@ static PyObject *countpairs_countpairs_rp_pi_mocks(PyObject *self, PyObject *arg
                                        &(options.max_cells_per_dim),
                                        &(options.c_api_timer),
                                        &(options.instruction_set),
-                                       &weighting_method_str)
+                                       &weighting_method_str,
+                                       &cell_ordering,
+                                       &(options.use_kdtree),
+                                       &ngb_stencil,
+                                       &(options.mixed_precision))
 
          ) {
 
@@ -996,6 +1035,8 @@ static PyObject *countpairs_countpairs_rp_pi_mocks(PyObject *self, PyObject *arg
         options.bin_refine_factors[2] = zbin_ref;
         set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
     }
+    set_cell_ordering(&options, cell_ordering);
+    set_ngb_scheme(&options, ngb_stencil ? BINNING_NGB_STENCIL:BINNING_NGB_LIST);
 
 
     
@@ -1025,6 +1066,14 @@ static PyObject *countpairs_countpairs_rp_pi_mocks(PyObject *self, PyObject *arg
         countpairs_mocks_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_mocks_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -1255,11 +1304,13 @@ static PyObject *countpairs_countpairs_theta_mocks(PyObject *self, PyObject *arg
         "c_api_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
         "weight_type",
+        "use_kdtree",/* pair the leaves of a kd-tree instead of the cells of the lattice */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
         NULL
     };
 
 
-    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iisO!O!|O!O!O!O!bbbbbbbhbis", kwlist,
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iisO!O!|O!O!O!O!bbbbbbbhbisbb", kwlist,
                                        &autocorr,&nthreads,&binfile,
                                        &PyArray_Type,&x1_obj,
                                        &PyArray_Type,&y1_obj,
@@ -1276,7 +1327,9 @@ static PyObject *countpairs_countpairs_theta_mocks(PyObject *self, PyObject *arg
                                        &(options.max_cells_per_dim),
                                        &(options.c_api_timer),
                                        &(options.instruction_set),
-                                       &weighting_method_str)
+                                       &weighting_method_str,
+                                       &(options.use_kdtree),
+                                       &(options.mixed_precision))
 
          ) {
         PyObject_Print(kwargs, stdout, 0);
@@ -1335,6 +1388,14 @@ static PyObject *countpairs_countpairs_theta_mocks(PyObject *self, PyObject *arg
         countpairs_mocks_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_mocks_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -0,0 +1,603 @@
+/* File: test_consistency_mocks.c */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/* Checks of the mocks results against the same statistic computed through
+   a different entry point, without a stored output file. The catalogs are
+   generated here (uniform plus clustered points in a patch of the sky, and
+   uniform randoms in the same patch) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <inttypes.h>
+
+#ifndef MAXLEN
+#define MAXLEN 500
+#endif
+
+#include "defs.h"
+#include "utils.h"
+#include "cosmology_params.h"
+
+#include "../DDrppi_mocks/countpairs_rp_pi_mocks.h"
+#include "../DDtheta_mocks/countpairs_theta_mocks.h"
+#include "../vpf_mocks/countspheres_mocks.h"
+
+void generate_catalogs(void);
+
+int test_regions_rp_pi(void);
+int test_regions_theta(void);
+int test_fused_dd_dr_rr(void);
+int test_isa_rp_pi(void);
+int test_isa_theta(void);
+int test_isa_vpf(void);
+
+//Global variables
+#define NDATA 12000
+#define NRAND 8000
+int ND1;
+double *RA1=NULL,*DEC1=NULL,*CZ1=NULL,*weights1=NULL;
+
+//the randoms (uniform in the same patch)
+int ND2;
+double *RA2=NULL,*DEC2=NULL,*CZ2=NULL,*weights2=NULL;
+
+/* The patch of the sky (degrees) and the range in cz (km/s) of the catalogs */
+const double ramin = 160.0, ramax = 200.0;
+const double decmin = 0.0, decmax = 30.0;
+const double czmin = 5000.0, czmax = 25000.0;
+
+char binfile[]="../tests/bins";
+char angular_binfile[]="../tests/angular_bins";
+const double pimax=40.0;
+#if defined(_OPENMP)
+const int nthreads=4;
+#else
+const int nthreads=1;
+#endif
+const int cosmology_flag=1;
+
+struct config_options options;
+const double maxdiff = 1e-9;
+const double maxreldiff = 1e-6;
+
+/* The instruction sets the kernels are checked with, against the fallback kernels (the library drops an
+   instruction set the cpu does not support to the next one down) */
+const int test_isa[] = {FALLBACK, SSE42, AVX, AVX512F};
+const char test_isa_names[][MAXLEN] = {"fallback", "SSE4.2", "AVX", "AVX512F"};
+const int ntest_isa = sizeof(test_isa)/sizeof(test_isa[0]);
+
+/* The region labels of the tests: stripes in RA */
+const int32_t nregions = 4;
+//end global variables
+
+/* Deterministic random numbers in [0, 1) -> the same catalogs on every machine */
+static uint64_t rng_state = 12345;
+static double random_uniform(void)
+{
+    rng_state = rng_state*6364136223846793005ULL + 1442695040888963407ULL;
+    return (rng_state >> 11)*(1.0/9007199254740992.0);
+}
+
+/* The region label (a stripe in RA) of every particle -> the caller frees the labels */
+static int32_t *get_region_labels(const int64_t N, const double *ra)
+{
+    int32_t *regions = my_malloc(sizeof(*regions), N);
+    if(regions == NULL) {
+        return NULL;
+    }
+    for(int64_t i=0;i<N;i++) {
+        const int32_t reg = (int32_t) ((ra[i] - ramin)*nregions/(ramax - ramin));
+        regions[i] = reg < 0 ? 0:(reg >= nregions ? nregions - 1:reg);
+    }
+    return regions;
+}
+
+/* npairs must be identical and the averages equal to within the tolerances, in every (rp, pi) bin */
+static int compare_results_rp_pi(const char *name, const results_countpairs_mocks *expected, const results_countpairs_mocks *computed)
+{
+    if(expected->nbin != computed->nbin || expected->npibin != computed->npibin) {
+        fprintf(stderr,"Failed (%s). True (nbin, npibin) = (%d, %d) Computed (nbin, npibin) = (%d, %d)\n",
+                name, expected->nbin, expected->npibin, computed->nbin, computed->npibin);
+        return EXIT_FAILURE;
+    }
+    for(int i=0;i<expected->nbin;i++) {
+        for(int j=0;j<expected->npibin;j++) {
+            const int index = i*(expected->npibin + 1) + j;
+            int rpavg_equal = AlmostEqualRelativeAndAbs_double(expected->rpavg[index], computed->rpavg[index], maxdiff, maxreldiff);
+            int weights_equal = AlmostEqualRelativeAndAbs_double(expected->weightavg[index], computed->weightavg[index], maxdiff, maxreldiff);
+            if(expected->npairs[index] != computed->npairs[index] || rpavg_equal != EXIT_SUCCESS || weights_equal != EXIT_SUCCESS) {
+                fprintf(stderr,"Failed (%s) in bin (%d, %d). True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n",
+                        name, i, j, expected->npairs[index], computed->npairs[index]);
+                fprintf(stderr,"Failed (%s) in bin (%d, %d). True rpavg = %e Computed rpavg = %e\n",
+                        name, i, j, expected->rpavg[index], computed->rpavg[index]);
+                fprintf(stderr,"Failed (%s) in bin (%d, %d). True weightavg = %e Computed weightavg = %e\n",
+                        name, i, j, expected->weightavg[index], computed->weightavg[index]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Same as compare_results_rp_pi for the angular bins */
+static int compare_results_theta(const char *name, const results_countpairs_theta *expected, const results_countpairs_theta *computed)
+{
+    if(expected->nbin != computed->nbin) {
+        fprintf(stderr,"Failed (%s). True nbin = %d Computed nbin = %d\n", name, expected->nbin, computed->nbin);
+        return EXIT_FAILURE;
+    }
+    for(int k=1;k<expected->nbin;k++) {
+        int thetaavg_equal = AlmostEqualRelativeAndAbs_double(expected->theta_avg[k], computed->theta_avg[k], maxdiff, maxreldiff);
+        int weights_equal = AlmostEqualRelativeAndAbs_double(expected->weightavg[k], computed->weightavg[k], maxdiff, maxreldiff);
+        if(expected->npairs[k] != computed->npairs[k] || thetaavg_equal != EXIT_SUCCESS || weights_equal != EXIT_SUCCESS) {
+            fprintf(stderr,"Failed (%s) in bin %d. True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n",
+                    name, k, expected->npairs[k], computed->npairs[k]);
+            fprintf(stderr,"Failed (%s) in bin %d. True theta_avg = %e Computed theta_avg = %e\n",
+                    name, k, expected->theta_avg[k], computed->theta_avg[k]);
+            fprintf(stderr,"Failed (%s) in bin %d. True weightavg = %e Computed weightavg = %e\n",
+                    name, k, expected->weightavg[k], computed->weightavg[k]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* The weighted DD(rp, pi) of the data (autocorr) or of the data with the randoms. The region labels (if any) are
+   set in extra by the caller */
+static int count_rp_pi(const int autocorr, struct extra_options *extra, results_countpairs_mocks *results)
+{
+    extra->weights0.weights[0] = weights1;
+    extra->weights1.weights[0] = autocorr ? weights1:weights2;
+    return countpairs_mocks(ND1, RA1, DEC1, CZ1,
+                            autocorr ? ND1:ND2, autocorr ? RA1:RA2, autocorr ? DEC1:DEC2, autocorr ? CZ1:CZ2,
+                            nthreads, autocorr, binfile, pimax, cosmology_flag, results, &options, extra);
+}
+
+/* Same as count_rp_pi for DD(theta) */
+static int count_theta(const int autocorr, struct extra_options *extra, results_countpairs_theta *results)
+{
+    extra->weights0.weights[0] = weights1;
+    extra->weights1.weights[0] = autocorr ? weights1:weights2;
+    return countpairs_theta_mocks(ND1, RA1, DEC1,
+                                  autocorr ? ND1:ND2, autocorr ? RA1:RA2, autocorr ? DEC1:DEC2,
+                                  nthreads, autocorr, angular_binfile, results, &options, extra);
+}
+
+/* The sum over all the pairs of regions of region_npairs against npairs, in the bin at index (the region matrix holds
+   stride bins per pair of regions) */
+static int check_region_sum(const char *name, const int64_t stride, const int64_t index, const uint64_t *npairs, const uint64_t *region_npairs)
+{
+    uint64_t sum = 0;
+    for(int r=0;r<nregions*nregions;r++) {
+        sum += region_npairs[r*stride + index];
+    }
+    if(sum != npairs[index]) {
+        fprintf(stderr,"Failed (%s) in bin %"PRId64". Total npairs = %"PRIu64" Sum over the regions = %"PRIu64"\n",
+                name, index, npairs[index], sum);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* The particles of the data with the label reg (copied into ra/dec/cz/w) -> the number of particles copied */
+static int64_t select_region(const int32_t *regions, const int32_t reg, double *ra, double *dec, double *cz, double *w)
+{
+    int64_t np = 0;
+    for(int64_t i=0;i<ND1;i++) {
+        if(regions[i] == reg) {
+            ra[np] = RA1[i];dec[np] = DEC1[i];cz[np] = CZ1[i];w[np] = weights1[i];
+            np++;
+        }
+    }
+    return np;
+}
+
+/* DDrppi_mocks with region labels (auto and cross with the randoms): the counts equal the counts without labels, the
+   region matrix sums to the totals, and (auto) the pairs within every region are the autocorrelation of that region */
+int test_regions_rp_pi(void)
+{
+    int32_t *regions1 = get_region_labels(ND1, RA1);
+    int32_t *regions2 = get_region_labels(ND2, RA2);
+    double *rra = my_malloc(sizeof(*rra), ND1), *rdec = my_malloc(sizeof(*rdec), ND1);
+    double *rcz = my_malloc(sizeof(*rcz), ND1), *rw = my_malloc(sizeof(*rw), ND1);
+    if(regions1 == NULL || regions2 == NULL || rra == NULL || rdec == NULL || rcz == NULL || rw == NULL) {
+        free(regions1);free(regions2);free(rra);free(rdec);free(rcz);free(rw);
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        results_countpairs_mocks expected, results;
+        ret = count_rp_pi(autocorr, &extra, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        extra.nregions = nregions;
+        extra.regions0 = regions1;
+        extra.regions1 = autocorr ? regions1:regions2;
+        ret = count_rp_pi(autocorr, &extra, &results);
+        if(ret != EXIT_SUCCESS) {
+            free_results_mocks(&expected);
+            break;
+        }
+        ret = compare_results_rp_pi(autocorr ? "DDrppi_mocks with regions (auto)":"DDrppi_mocks with regions (cross)", &expected, &results);
+        //the region matrix is laid out with (nbin + 1)*(npibin + 1) bins per pair of regions
+        const int64_t totnbins = (int64_t) (results.nbin + 1)*(results.npibin + 1);
+        for(int i=0;i<results.nbin && ret == EXIT_SUCCESS;i++) {
+            for(int j=0;j<results.npibin && ret == EXIT_SUCCESS;j++) {
+                ret = check_region_sum(autocorr ? "DDrppi_mocks region sums (auto)":"DDrppi_mocks region sums (cross)",
+                                       totnbins, i*(results.npibin + 1) + j, results.npairs, results.region_npairs);
+            }
+        }
+
+        for(int32_t reg=0;reg<nregions && autocorr == 1 && ret == EXIT_SUCCESS;reg++) {
+            const int64_t np = select_region(regions1, reg, rra, rdec, rcz, rw);
+            struct extra_options extra_region = get_extra_options(PAIR_PRODUCT);
+            extra_region.weights0.weights[0] = rw;
+            extra_region.weights1.weights[0] = rw;
+            results_countpairs_mocks region_results;
+            ret = countpairs_mocks(np, rra, rdec, rcz, np, rra, rdec, rcz, nthreads, 1, binfile, pimax, cosmology_flag,
+                                   &region_results, &options, &extra_region);
+            if(ret != EXIT_SUCCESS) {
+                break;
+            }
+            for(int i=0;i<results.nbin && ret == EXIT_SUCCESS;i++) {
+                for(int j=0;j<results.npibin;j++) {
+                    const int index = i*(results.npibin + 1) + j;
+                    const uint64_t npairs = results.region_npairs[(reg*nregions + reg)*totnbins + index];
+                    if(npairs != region_results.npairs[index]) {
+                        fprintf(stderr,"Failed (DDrppi_mocks regions) in bin (%d, %d). npairs within region %d = %"PRIu64" Autocorrelation of the region = %"PRIu64"\n",
+                                i, j, reg, npairs, region_results.npairs[index]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+            }
+            free_results_mocks(&region_results);
+        }
+        free_results_mocks(&results);
+        free_results_mocks(&expected);
+    }
+    free(regions1);free(regions2);free(rra);free(rdec);free(rcz);free(rw);
+    return ret;
+}
+
+/* Same as test_regions_rp_pi for DDtheta_mocks */
+int test_regions_theta(void)
+{
+    int32_t *regions1 = get_region_labels(ND1, RA1);
+    int32_t *regions2 = get_region_labels(ND2, RA2);
+    double *rra = my_malloc(sizeof(*rra), ND1), *rdec = my_malloc(sizeof(*rdec), ND1);
+    double *rcz = my_malloc(sizeof(*rcz), ND1), *rw = my_malloc(sizeof(*rw), ND1);
+    if(regions1 == NULL || regions2 == NULL || rra == NULL || rdec == NULL || rcz == NULL || rw == NULL) {
+        free(regions1);free(regions2);free(rra);free(rdec);free(rcz);free(rw);
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        results_countpairs_theta expected, results;
+        ret = count_theta(autocorr, &extra, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        extra.nregions = nregions;
+        extra.regions0 = regions1;
+        extra.regions1 = autocorr ? regions1:regions2;
+        ret = count_theta(autocorr, &extra, &results);
+        if(ret != EXIT_SUCCESS) {
+            free_results_countpairs_theta(&expected);
+            break;
+        }
+        ret = compare_results_theta(autocorr ? "DDtheta_mocks with regions (auto)":"DDtheta_mocks with regions (cross)", &expected, &results);
+        for(int k=1;k<results.nbin && ret == EXIT_SUCCESS;k++) {
+            ret = check_region_sum(autocorr ? "DDtheta_mocks region sums (auto)":"DDtheta_mocks region sums (cross)",
+                                   results.nbin, k, results.npairs, results.region_npairs);
+        }
+
+        for(int32_t reg=0;reg<nregions && autocorr == 1 && ret == EXIT_SUCCESS;reg++) {
+            const int64_t np = select_region(regions1, reg, rra, rdec, rcz, rw);
+            struct extra_options extra_region = get_extra_options(PAIR_PRODUCT);
+            extra_region.weights0.weights[0] = rw;
+            extra_region.weights1.weights[0] = rw;
+            results_countpairs_theta region_results;
+            ret = countpairs_theta_mocks(np, rra, rdec, np, rra, rdec, nthreads, 1, angular_binfile,
+                                         &region_results, &options, &extra_region);
+            if(ret != EXIT_SUCCESS) {
+                break;
+            }
+            for(int k=1;k<results.nbin;k++) {
+                const uint64_t npairs = results.region_npairs[(reg*nregions + reg)*results.nbin + k];
+                if(npairs != region_results.npairs[k]) {
+                    fprintf(stderr,"Failed (DDtheta_mocks regions) in bin %d. npairs within region %d = %"PRIu64" Autocorrelation of the region = %"PRIu64"\n",
+                            k, reg, npairs, region_results.npairs[k]);
+                    ret = EXIT_FAILURE;
+                    break;
+                }
+            }
+            free_results_countpairs_theta(&region_results);
+        }
+        free_results_countpairs_theta(&results);
+        free_results_countpairs_theta(&expected);
+    }
+    free(regions1);free(regions2);free(rra);free(rdec);free(rcz);free(rw);
+    return ret;
+}
+
+/* The fused DD, DR and RR of countpairs_mocks_dd_dr_rr against three separate calls to countpairs_mocks */
+int test_fused_dd_dr_rr(void)
+{
+    struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+    extra.weights0.weights[0] = weights1;
+    extra.weights1.weights[0] = weights2;
+    results_countpairs_mocks dd, dr, rr;
+    int ret = countpairs_mocks_dd_dr_rr(ND1, RA1, DEC1, CZ1, ND2, RA2, DEC2, CZ2, nthreads, binfile, pimax, cosmology_flag,
+                                        &dd, &dr, &rr, &options, &extra);
+    if(ret != EXIT_SUCCESS) {
+        return ret;
+    }
+
+    results_countpairs_mocks expected;
+    for(int k=0;k<3 && ret == EXIT_SUCCESS;k++) {
+        struct extra_options extra_single = get_extra_options(PAIR_PRODUCT);
+        if(k < 2) {
+            //DD (autocorr) and DR (the data with the randoms)
+            ret = count_rp_pi(k == 0, &extra_single, &expected);
+        } else {
+            extra_single.weights0.weights[0] = weights2;
+            extra_single.weights1.weights[0] = weights2;
+            ret = countpairs_mocks(ND2, RA2, DEC2, CZ2, ND2, RA2, DEC2, CZ2, nthreads, 1, binfile, pimax, cosmology_flag,
+                                   &expected, &options, &extra_single);
+        }
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        const char *names[] = {"fused DD", "fused DR", "fused RR"};
+        const results_countpairs_mocks *fused[] = {&dd, &dr, &rr};
+        ret = compare_results_rp_pi(names[k], &expected, fused[k]);
+        free_results_mocks(&expected);
+    }
+    free_results_mocks(&dd);free_results_mocks(&dr);free_results_mocks(&rr);
+    return ret;
+}
+
+/* DDrppi_mocks (auto and cross with the randoms) with every instruction set against the fallback kernels */
+int test_isa_rp_pi(void)
+{
+    int ret = EXIT_SUCCESS;
+    const int save_isa = options.instruction_set;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        results_countpairs_mocks expected;
+        options.instruction_set = FALLBACK;
+        ret = count_rp_pi(autocorr, &extra, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        for(int iset=1;iset<ntest_isa && ret == EXIT_SUCCESS;iset++) {
+            options.instruction_set = test_isa[iset];
+            results_countpairs_mocks results;
+            ret = count_rp_pi(autocorr, &extra, &results);
+            if(ret == EXIT_SUCCESS) {
+                char name[MAXLEN];
+                my_snprintf(name, MAXLEN, "DDrppi_mocks (%s, autocorr = %d)", test_isa_names[iset], autocorr);
+                ret = compare_results_rp_pi(name, &expected, &results);
+                free_results_mocks(&results);
+            }
+        }
+        free_results_mocks(&expected);
+    }
+    options.instruction_set = save_isa;
+    return ret;
+}
+
+/* Same as test_isa_rp_pi for DDtheta_mocks */
+int test_isa_theta(void)
+{
+    int ret = EXIT_SUCCESS;
+    const int save_isa = options.instruction_set;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        results_countpairs_theta expected;
+        options.instruction_set = FALLBACK;
+        ret = count_theta(autocorr, &extra, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        for(int iset=1;iset<ntest_isa && ret == EXIT_SUCCESS;iset++) {
+            options.instruction_set = test_isa[iset];
+            results_countpairs_theta results;
+            ret = count_theta(autocorr, &extra, &results);
+            if(ret == EXIT_SUCCESS) {
+                char name[MAXLEN];
+                my_snprintf(name, MAXLEN, "DDtheta_mocks (%s, autocorr = %d)", test_isa_names[iset], autocorr);
+                ret = compare_results_theta(name, &expected, &results);
+                free_results_countpairs_theta(&results);
+            }
+        }
+        free_results_countpairs_theta(&expected);
+    }
+    options.instruction_set = save_isa;
+    return ret;
+}
+
+/* vpf_mocks with every instruction set against the fallback kernels. The sphere centers are drawn from the randoms
+   into a scratch centers file by the first call, and then read back by all the others -> the same spheres */
+int test_isa_vpf(void)
+{
+    const double rmax=10.0;
+    const int nbin=10;
+    const int nc=2000;
+    const int num_pN=6;
+    const int threshold_neighbors=1;
+    const char centers_file[]="test_consistency_mocks_centers.txt";
+
+    int ret = EXIT_SUCCESS;
+    const int save_isa = options.instruction_set;
+    remove(centers_file);
+    results_countspheres_mocks expected, results;
+    options.instruction_set = FALLBACK;
+    for(int k=0;k<2 && ret == EXIT_SUCCESS;k++) {
+        ret = countspheres_mocks(ND1, RA1, DEC1, CZ1, ND2, RA2, DEC2, CZ2, threshold_neighbors, rmax, nbin, nc, num_pN,
+                                 centers_file, cosmology_flag, &expected, &options, NULL);
+        //the first call only writes the centers
+        if(ret == EXIT_SUCCESS && k == 0) {
+            free_results_countspheres_mocks(&expected);
+        }
+    }
+    if(ret != EXIT_SUCCESS) {
+        options.instruction_set = save_isa;
+        remove(centers_file);
+        return ret;
+    }
+
+    for(int iset=1;iset<ntest_isa && ret == EXIT_SUCCESS;iset++) {
+        options.instruction_set = test_isa[iset];
+        ret = countspheres_mocks(ND1, RA1, DEC1, CZ1, ND2, RA2, DEC2, CZ2, threshold_neighbors, rmax, nbin, nc, num_pN,
+                                 centers_file, cosmology_flag, &results, &options, NULL);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        for(int ibin=0;ibin<nbin && ret == EXIT_SUCCESS;ibin++) {
+            for(int i=0;i<num_pN;i++) {
+                if(AlmostEqualRelativeAndAbs_double(expected.pN[ibin][i], results.pN[ibin][i], maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                    fprintf(stderr,"Failed (vpf_mocks, %s) in bin %d. True pN[%d] = %e Computed pN[%d] = %e\n",
+                            test_isa_names[iset], ibin, i, expected.pN[ibin][i], i, results.pN[ibin][i]);
+                    ret = EXIT_FAILURE;
+                    break;
+                }
+            }
+        }
+        free_results_countspheres_mocks(&results);
+    }
+    free_results_countspheres_mocks(&expected);
+    options.instruction_set = save_isa;
+    remove(centers_file);
+    return ret;
+}
+
+/* Uniform positions in the patch (in area and in cz) into ra/dec/cz, with half of them (clustered != 0) in a few
+   clumps of ~1 degree -> pairs in the small bins */
+static void generate_positions(const int64_t N, const int clustered, double *ra, double *dec, double *cz, double *w)
+{
+    const double sin_decmin = sin(decmin*M_PI/180.0), sin_decmax = sin(decmax*M_PI/180.0);
+    for(int64_t i=0;i<N;i++) {
+        if(clustered && (i % 2)) {
+            const int64_t c = i % 7;
+            ra[i] = ramin + 5.0 + 4.5*c + (random_uniform() - 0.5);
+            dec[i] = decmin + 5.0 + 3.0*c + (random_uniform() - 0.5);
+            cz[i] = czmin + 2000.0 + 2500.0*c + 600.0*(random_uniform() - 0.5);
+        } else {
+            ra[i] = ramin + (ramax - ramin)*random_uniform();
+            dec[i] = asin(sin_decmin + (sin_decmax - sin_decmin)*random_uniform())*180.0/M_PI;
+            cz[i] = czmin + (czmax - czmin)*random_uniform();
+        }
+        w[i] = 0.5 + random_uniform();
+    }
+}
+
+void generate_catalogs(void)
+{
+    ND1 = NDATA;
+    RA1 = my_malloc(sizeof(*RA1), ND1);
+    DEC1 = my_malloc(sizeof(*DEC1), ND1);
+    CZ1 = my_malloc(sizeof(*CZ1), ND1);
+    weights1 = my_malloc(sizeof(*weights1), ND1);
+    assert(RA1 != NULL && DEC1 != NULL && CZ1 != NULL && weights1 != NULL && "Allocated the test catalog");
+    generate_positions(ND1, 1, RA1, DEC1, CZ1, weights1);
+
+    ND2 = NRAND;
+    RA2 = my_malloc(sizeof(*RA2), ND2);
+    DEC2 = my_malloc(sizeof(*DEC2), ND2);
+    CZ2 = my_malloc(sizeof(*CZ2), ND2);
+    weights2 = my_malloc(sizeof(*weights2), ND2);
+    assert(RA2 != NULL && DEC2 != NULL && CZ2 != NULL && weights2 != NULL && "Allocated the randoms");
+    generate_positions(ND2, 0, RA2, DEC2, CZ2, weights2);
+}
+
+int main(int argc, char **argv)
+{
+    struct timeval tstart,t0,t1;
+    options = get_config_options();
+    options.need_avg_sep=1;
+    options.verbose=0;
+    options.periodic=0;
+    options.float_type=sizeof(double);
+    options.fast_divide=0;
+    options.fast_acos=0;
+
+    int status = init_cosmology(cosmology_flag);
+    if(status != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    gettimeofday(&tstart,NULL);
+    generate_catalogs();
+    reset_bin_refine_factors(&options);
+
+    int failed=0;
+
+    const char alltests_names[][MAXLEN] = {"DDrppi_mocks with region labels",
+                                           "DDtheta_mocks with region labels",
+                                           "Fused DD, DR and RR against separate calls",
+                                           "DDrppi_mocks with every instruction set",
+                                           "DDtheta_mocks with every instruction set",
+                                           "vpf_mocks with every instruction set"};
+    int (*allfunctions[]) (void) = {test_regions_rp_pi,
+                                    test_regions_theta,
+                                    test_fused_dd_dr_rr,
+                                    test_isa_rp_pi,
+                                    test_isa_theta,
+                                    test_isa_vpf};
+    const int ntests = sizeof(alltests_names)/(sizeof(char)*MAXLEN);
+    const int numfunctions = sizeof(allfunctions)/sizeof(allfunctions[0]);
+    assert(ntests == numfunctions && "Every test has a name");
+
+    int total_tests=0;
+    for(int i=0;i<ntests;i++) {
+        // nothing was passed at the command-line -> run all tests
+        if(argc > 1) {
+            int requested = 0;
+            for(int a=1;a<argc;a++) {
+                if(atoi(argv[a]) == i) {
+                    requested = 1;
+                }
+            }
+            if(requested == 0) continue;
+        }
+        const char *testname = alltests_names[i];
+        gettimeofday(&t0,NULL);
+        status = (*allfunctions[i])();
+        gettimeofday(&t1,NULL);
+        double pair_time = ADD_DIFF_TIME(t0,t1);
+        total_tests++;
+        if(status==EXIT_SUCCESS) {
+            fprintf(stderr,ANSI_COLOR_GREEN "PASSED: " ANSI_COLOR_MAGENTA "%s" ANSI_COLOR_GREEN ". Time taken = %8.2lf seconds " ANSI_COLOR_RESET "\n", testname,pair_time);
+        } else {
+            fprintf(stderr,ANSI_COLOR_RED "FAILED: " ANSI_COLOR_MAGENTA "%s" ANSI_COLOR_RED ". Time taken = %8.2lf seconds " ANSI_COLOR_RESET "\n", testname,pair_time);
+            failed++;
+        }
+    }
+
+    gettimeofday(&t1,NULL);
+    double total_time = ADD_DIFF_TIME(tstart,t1);
+    if(failed > 0) {
+        fprintf(stderr,ANSI_COLOR_RED "FAILED %d out of %d tests. Total time = %8.2lf seconds " ANSI_COLOR_RESET "\n", failed, total_tests, total_time);
+    } else {
+        fprintf(stderr,ANSI_COLOR_GREEN "PASSED: ALL %d tests. Total time = %8.2lf seconds " ANSI_COLOR_RESET "\n", total_tests, total_time);
+    }
+
+    free(RA1);free(DEC1);free(CZ1);free(weights1);
+    free(RA2);free(DEC2);free(CZ2);free(weights2);
+    return failed;
+}
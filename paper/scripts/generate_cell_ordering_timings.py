@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+
+"""
+Compares the runtimes of the pair-counters for the different orderings of the
+cells in the lattice (`cell_ordering` = 'rowmajor', 'morton' or 'hilbert'),
+on the Mr19 test catalogs.
+
+Usage:
+    python generate_cell_ordering_timings.py            # runs the benchmarks
+    python generate_cell_ordering_timings.py <npz file> # prints the table
+"""
+from __future__ import print_function
+
+import numpy as np
+
+import Corrfunc
+
+from Corrfunc.io import read_catalog
+from os.path import join as pjoin, abspath, dirname
+import sys
+
+import multiprocessing
+max_threads = multiprocessing.cpu_count()
+
+all_orderings = ['rowmajor', 'morton', 'hilbert']
+
+
+def benchmark_cell_ordering(rmax_array=[10.0, 20.0, 40.0, 80.0],
+                            nrepeats=3,
+                            orderings=all_orderings,
+                            isa='fastest'):
+    from Corrfunc.theory import DD, DDrppi, wp, xi
+    from Corrfunc.mocks import DDrppi_mocks
+
+    for o in orderings:
+        if o not in all_orderings:
+            msg = "Valid cell orderings are: {0}\nFound ordering"\
+                  " = {1}".format(all_orderings, o)
+            raise ValueError(msg)
+
+    x, y, z = read_catalog()
+    boxsize = 420.0
+
+    mocks_file = pjoin(dirname(abspath(Corrfunc.__file__)),
+                       "../mocks/tests/data", "Mr19_mock_northonly.rdcz.ff")
+    ra, dec, cz = read_catalog(mocks_file)
+    cosmology = 1
+
+    rmin = 0.1
+    nbins = 20
+    nthreads = max_threads
+    keys = ['DD', 'DDrppi', 'wp', 'xi', 'DDrppi (mocks)']
+
+    dtype = np.dtype([('repeat', np.int),
+                      ('name', 'S16'),
+                      ('ordering', 'S16'),
+                      ('rmax', np.float),
+                      ('nthreads', np.int),
+                      ('api_time', np.float)])
+
+    totN = len(rmax_array) * len(keys) * len(orderings) * nrepeats
+    runtimes = np.empty(totN, dtype=dtype)
+    index = 0
+    for rmax in rmax_array:
+        bins = np.logspace(np.log10(rmin), np.log10(rmax), nbins)
+        pimax = rmax
+        print("Working on rmax = {0}".format(rmax), file=sys.stderr)
+        for ordering in orderings:
+            calls = {
+                'DD': lambda: DD(1, nthreads, bins, x, y, z,
+                                 periodic=True, boxsize=boxsize,
+                                 c_api_timer=True, isa=isa,
+                                 cell_ordering=ordering),
+                'DDrppi': lambda: DDrppi(1, nthreads, pimax, bins, x, y, z,
+                                         periodic=True, boxsize=boxsize,
+                                         c_api_timer=True, isa=isa,
+                                         cell_ordering=ordering),
+                'wp': lambda: wp(boxsize, pimax, nthreads, bins, x, y, z,
+                                 c_api_timer=True, isa=isa,
+                                 cell_ordering=ordering),
+                'xi': lambda: xi(boxsize, nthreads, bins, x, y, z,
+                                 c_api_timer=True, isa=isa,
+                                 cell_ordering=ordering),
+                'DDrppi (mocks)': lambda: DDrppi_mocks(1, cosmology, nthreads,
+                                                       pimax, bins,
+                                                       ra, dec, cz,
+                                                       c_api_timer=True,
+                                                       isa=isa,
+                                                       cell_ordering=ordering),
+            }
+            for name in keys:
+                for repeat in range(nrepeats):
+                    _, api_time = calls[name]()
+                    runtimes['repeat'][index] = repeat
+                    runtimes['name'][index] = name
+                    runtimes['ordering'][index] = ordering
+                    runtimes['rmax'][index] = rmax
+                    runtimes['nthreads'][index] = nthreads
+                    runtimes['api_time'][index] = api_time
+                    index += 1
+
+    return keys, orderings, runtimes
+
+
+def print_timings(keys, orderings, runtimes):
+    all_rmax = np.array(sorted(list(set(runtimes['rmax']))))
+    print("# {0:14s} {1:>8s} ".format("Routine", "rmax"), end='')
+    for ordering in orderings:
+        print("{0:>12s}".format(ordering), end='')
+    print("   (mean time [sec] and speedup over rowmajor)")
+    for name in keys:
+        for rmax in all_rmax:
+            print("  {0:14s} {1:8.1f} ".format(name, rmax), end='')
+            base = None
+            for ordering in orderings:
+                ind = (runtimes['rmax'] == rmax) & \
+                      (runtimes['name'] == name.encode()) & \
+                      (runtimes['ordering'] == ordering.encode())
+                t = np.mean(runtimes['api_time'][ind])
+                if base is None:
+                    base = t
+                print("{0:7.2f}({1:3.2f})".format(t, base/t), end='')
+            print("")
+
+
+if len(sys.argv) == 1:
+    print("Running cell ordering benchmarks with nthreads = {0}"
+          .format(max_threads))
+    keys, orderings, runtimes = benchmark_cell_ordering()
+    np.savez('cell_ordering_timings.npz', keys=keys, orderings=orderings,
+             runtimes=runtimes)
+else:
+    timings_file = sys.argv[1]
+    print("Loading benchmarks from file = {0}".format(timings_file))
+    xx = np.load(timings_file)
+    keys = [str(k) for k in xx['keys']]
+    orderings = [str(o) for o in xx['orderings']]
+    runtimes = xx['runtimes']
+
+print_timings(keys, orderings, runtimes)
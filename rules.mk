@@ -1,10 +1,10 @@
 TARGETOBJS := $(TARGETSRC:.c=.o)
 LIBOBJS :=$(LIBSRC:.c=.o)
 
-gridlink_impl_double.o:gridlink_impl_double.c gridlink_impl_double.h
-gridlink_impl_float.o:gridlink_impl_float.c gridlink_impl_float.h 
-gridlink_mocks_impl_double.o:gridlink_mocks_impl_double.c gridlink_mocks_impl_double.h
-gridlink_mocks_impl_float.o:gridlink_mocks_impl_float.c gridlink_mocks_impl_float.h 
+gridlink_impl_double.o:gridlink_impl_double.c gridlink_impl_double.h sort_cells_double.h cell_ordering.h ngb_stencil.h particle_source.h
+gridlink_impl_float.o:gridlink_impl_float.c gridlink_impl_float.h sort_cells_float.h cell_ordering.h ngb_stencil.h particle_source.h
+gridlink_mocks_impl_double.o:gridlink_mocks_impl_double.c gridlink_mocks_impl_double.h sort_cells_double.h cell_ordering.h
+gridlink_mocks_impl_float.o:gridlink_mocks_impl_float.c gridlink_mocks_impl_float.h sort_cells_float.h cell_ordering.h
 gridlink_impl_double.h:cellarray_double.h
 gridlink_impl_float.h:cellarray_float.h
 cellarray_double.h:weight_functions_double.h
@@ -13,6 +13,21 @@ weight_functions_double.h:weight_defs_double.h
 weight_functions_float.h:weight_defs_float.h
 gridlink_mocks_impl_double.h:cellarray_mocks_double.h
 gridlink_mocks_impl_float.h:cellarray_mocks_float.h
+kdtree_impl_double.h:cellarray_double.h cellarray_mocks_double.h gridlink_impl_double.h
+kdtree_impl_float.h:cellarray_float.h cellarray_mocks_float.h gridlink_impl_float.h
+$(UTILS_DIR)/kdtree_impl_double.h:$(UTILS_DIR)/cellarray_double.h $(UTILS_DIR)/cellarray_mocks_double.h $(UTILS_DIR)/gridlink_impl_double.h
+$(UTILS_DIR)/kdtree_impl_float.h:$(UTILS_DIR)/cellarray_float.h $(UTILS_DIR)/cellarray_mocks_float.h $(UTILS_DIR)/gridlink_impl_float.h
+kdtree_impl_double.o:kdtree_impl_double.c kdtree_impl_double.h gridlink_impl_double.h cellarray_double.h cellarray_mocks_double.h sort_cells_double.h
+kdtree_impl_float.o:kdtree_impl_float.c kdtree_impl_float.h gridlink_impl_float.h cellarray_float.h cellarray_mocks_float.h sort_cells_float.h
+$(UTILS_DIR)/gridlink_impl_double.o $(UTILS_DIR)/gridlink_mocks_impl_double.o:$(UTILS_DIR)/sort_cells_double.h $(UTILS_DIR)/sort_cells.h.src $(UTILS_DIR)/cell_ordering.h $(UTILS_DIR)/ngb_stencil.h $(UTILS_DIR)/particle_source.h
+$(UTILS_DIR)/gridlink_impl_float.o $(UTILS_DIR)/gridlink_mocks_impl_float.o:$(UTILS_DIR)/sort_cells_float.h $(UTILS_DIR)/sort_cells.h.src $(UTILS_DIR)/cell_ordering.h $(UTILS_DIR)/ngb_stencil.h $(UTILS_DIR)/particle_source.h
+$(UTILS_DIR)/kdtree_impl_double.o:$(UTILS_DIR)/kdtree_impl_double.h $(UTILS_DIR)/gridlink_impl_double.h $(UTILS_DIR)/cellarray_double.h $(UTILS_DIR)/cellarray_mocks_double.h $(UTILS_DIR)/sort_cells_double.h $(UTILS_DIR)/cell_ordering.h $(UTILS_DIR)/ngb_stencil.h
+$(UTILS_DIR)/kdtree_impl_float.o:$(UTILS_DIR)/kdtree_impl_float.h $(UTILS_DIR)/gridlink_impl_float.h $(UTILS_DIR)/cellarray_float.h $(UTILS_DIR)/cellarray_mocks_float.h $(UTILS_DIR)/sort_cells_float.h $(UTILS_DIR)/cell_ordering.h $(UTILS_DIR)/ngb_stencil.h
+$(UTILS_DIR)/prepared_catalog.o:$(UTILS_DIR)/prepared_catalog.h $(UTILS_DIR)/gridlink_impl_double.h $(UTILS_DIR)/gridlink_impl_float.h \
+                                $(UTILS_DIR)/cellarray_double.h $(UTILS_DIR)/cellarray_float.h \
+                                $(UTILS_DIR)/weight_defs_double.h $(UTILS_DIR)/weight_defs_float.h
+$(UTILS_DIR)/autotune.o:$(UTILS_DIR)/autotune.h $(UTILS_DIR)/defs.h $(UTILS_DIR)/cpu_features.h $(UTILS_DIR)/utils.h
+$(UTILS_DIR)/exec_context.o:$(UTILS_DIR)/exec_context.h $(UTILS_DIR)/defs.h $(UTILS_DIR)/progressbar.h
 
 .SUFFIXES:
 
@@ -65,12 +80,25 @@ $(LIBRARY): $(LIBOBJS) $(ROOT_DIR)/mocks.options $(ROOT_DIR)/theory.options $(RO
 $(INSTALL_LIB_DIR)/%.a: %.a | $(INSTALL_LIB_DIR) 
 	cp -p $(LIBRARY) $(INSTALL_LIB_DIR)/
 
-$(INSTALL_HEADERS_DIR)/%.h: %.h $(INSTALL_HEADERS_DIR)/defs.h | $(INSTALL_HEADERS_DIR)
+$(INSTALL_HEADERS_DIR)/%.h: %.h $(INSTALL_HEADERS_DIR)/defs.h $(INSTALL_HEADERS_DIR)/prepared_catalog.h $(INSTALL_HEADERS_DIR)/particle_source.h \
+                            $(INSTALL_HEADERS_DIR)/exec_context.h $(INSTALL_HEADERS_DIR)/progressbar.h | $(INSTALL_HEADERS_DIR)
 	cp -p $< $@
 
 $(INSTALL_HEADERS_DIR)/defs.h:$(UTILS_DIR)/defs.h | $(INSTALL_HEADERS_DIR)
 	cp -p $(UTILS_DIR)/defs.h $(INSTALL_HEADERS_DIR)/
 
+$(INSTALL_HEADERS_DIR)/prepared_catalog.h:$(UTILS_DIR)/prepared_catalog.h | $(INSTALL_HEADERS_DIR)
+	cp -p $(UTILS_DIR)/prepared_catalog.h $(INSTALL_HEADERS_DIR)/
+
+$(INSTALL_HEADERS_DIR)/particle_source.h:$(UTILS_DIR)/particle_source.h | $(INSTALL_HEADERS_DIR)
+	cp -p $(UTILS_DIR)/particle_source.h $(INSTALL_HEADERS_DIR)/
+
+$(INSTALL_HEADERS_DIR)/exec_context.h:$(UTILS_DIR)/exec_context.h | $(INSTALL_HEADERS_DIR)
+	cp -p $(UTILS_DIR)/exec_context.h $(INSTALL_HEADERS_DIR)/
+
+$(INSTALL_HEADERS_DIR)/progressbar.h:$(UTILS_DIR)/progressbar.h | $(INSTALL_HEADERS_DIR)
+	cp -p $(UTILS_DIR)/progressbar.h $(INSTALL_HEADERS_DIR)/
+
 $(INSTALL_BIN_DIR)/%: %
 	cp -p $< $(INSTALL_BIN_DIR)/
 
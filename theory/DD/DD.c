@@ -37,6 +37,10 @@
 #include "utils.h" //general utilities
 
 void Printhelp(void);
+int DD_streamed(const char *file1, const char *fileformat1, const char *weights_file1, const char *weights_fileformat1,
+                const char *file2, const char *fileformat2, const char *weights_file2, const char *weights_fileformat2,
+                const weight_method_t weight_method, const int num_weights,
+                const int nthreads, const int autocorr, const char *binfile, struct timeval t_start);
 
 int main(int argc, char *argv[])
 {
@@ -152,18 +156,23 @@ int main(int argc, char *argv[])
     }
     fprintf(stderr,"\t\t -------------------------------------\n");
 
+    int autocorr=0;
+    if( strcmp(file1,file2)==0) {
+        autocorr=1;
+    }
 
+    /* With a memory budget (MEMORY_BUDGET in theory.options), the particles are streamed from the files */
+    if(get_config_options().memory_budget > 0) {
+        return DD_streamed(file1, fileformat1, weights_file1, weights_fileformat1,
+                           file2, fileformat2, weights_file2, weights_fileformat2,
+                           weight_method, num_weights, nthreads, autocorr, binfile, t_start);
+    }
 
     /*---Read-data1-file----------------------------------*/
     gettimeofday(&t0,NULL);
     ND1=read_positions(file1,fileformat1, sizeof(DOUBLE), 3, &x1, &y1, &z1);
     gettimeofday(&t1,NULL);
     read_time += ADD_DIFF_TIME(t0,t1);
-
-    int autocorr=0;
-    if( strcmp(file1,file2)==0) {
-        autocorr=1;
-    }
   
     /* Read weights file 1 */
     if(weights_file1 != NULL){
@@ -263,6 +272,61 @@ int main(int argc, char *argv[])
     return EXIT_SUCCESS;
 }
 
+/*---Count-pairs-one-z-slab-at-a-time-----------------*/
+int DD_streamed(const char *file1, const char *fileformat1, const char *weights_file1, const char *weights_fileformat1,
+                const char *file2, const char *fileformat2, const char *weights_file2, const char *weights_fileformat2,
+                const weight_method_t weight_method, const int num_weights,
+                const int nthreads, const int autocorr, const char *binfile, struct timeval t_start)
+{
+    struct timeval t_end,t0,t1;
+    particle_source source1, source2;
+    if(open_particle_source(&source1, file1, fileformat1, weights_file1, weights_fileformat1,
+                            weights_file1 != NULL ? num_weights:0, sizeof(DOUBLE)) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if(autocorr == 0 &&
+       open_particle_source(&source2, file2, fileformat2, weights_file2, weights_fileformat2,
+                            weights_file2 != NULL ? num_weights:0, sizeof(DOUBLE)) != EXIT_SUCCESS) {
+        close_particle_source(&source1);
+        return EXIT_FAILURE;
+    }
+
+    gettimeofday(&t0,NULL);
+    struct config_options options = get_config_options();
+    struct extra_options extra = get_extra_options(weight_method);
+    results_countpairs results;
+    int status = countpairs_slabs(&source1, autocorr ? &source1:&source2,
+                                  nthreads,
+                                  autocorr,
+                                  binfile,
+                                  &results,
+                                  &options,
+                                  &extra);
+    const int64_t ND1 = source1.np;
+    const int64_t ND2 = autocorr ? source1.np:source2.np;
+    close_particle_source(&source1);
+    if(autocorr == 0) {
+        close_particle_source(&source2);
+    }
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+    gettimeofday(&t1,NULL);
+    double pair_time = ADD_DIFF_TIME(t0,t1);
+
+    DOUBLE rlow=results.rupp[0];
+    for(int i=1;i<results.nbin;i++) {
+        fprintf(stdout,"%e\t%e\t%e\t%12"PRIu64"\t%e\n",rlow, results.rupp[i], results.rpavg[i],results.npairs[i],results.weightavg[i]);
+        rlow=results.rupp[i];
+    }
+
+    free_results(&results);
+    gettimeofday(&t_end,NULL);
+    fprintf(stderr,"DD> Done -  ND1=%"PRId64" ND2=%"PRId64". Time taken = %6.2lf seconds (streamed the particles in z-slabs). pair-counting time = %6.2lf sec\n",
+            ND1,ND2,ADD_DIFF_TIME(t_start,t_end),pair_time);
+    return EXIT_SUCCESS;
+}
+
 /*---Print-help-information---------------------------*/
 void Printhelp(void)
 {
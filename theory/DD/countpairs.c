@@ -25,6 +25,19 @@ void free_results(results_countpairs *results)
     free(results->npairs);
     free(results->rpavg);
     free(results->weightavg);
+    free(results->region_npairs);
+}
+
+
+void free_results_delta(results_countpairs_delta *results)
+{
+    if(results == NULL)
+        return;
+
+    free(results->rupp);
+    free(results->npairs);
+    free(results->rpsum);
+    free(results->weightsum);
 }
 
 
@@ -73,3 +86,210 @@ int countpairs(const int64_t ND1, void * restrict X1, void * restrict Y1, void
     }
     
 }
+
+
+int countpairs_multi_bins(const int64_t ND1, void *X1, void *Y1, void *Z1,
+                          const int64_t ND2, void *X2, void *Y2, void *Z2,
+                          const int numthreads,
+                          const int autocorr,
+                          const int nbinfiles, const char **binfiles,
+                          results_countpairs *results,
+                          struct config_options *options,
+                          struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+            __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_multi_bins_float(ND1, (float *) X1, (float *) Y1, (float *) Z1,
+                                           ND2, (float *) X2, (float *) Y2, (float *) Z2,
+                                           numthreads,
+                                           autocorr,
+                                           nbinfiles, binfiles,
+                                           results,
+                                           options,
+                                           extra);
+    } else {
+        return countpairs_multi_bins_double(ND1, (double *) X1, (double *) Y1, (double *) Z1,
+                                            ND2, (double *) X2, (double *) Y2, (double *) Z2,
+                                            numthreads,
+                                            autocorr,
+                                            nbinfiles, binfiles,
+                                            results,
+                                            options,
+                                            extra);
+    }
+}
+
+
+int countpairs_dd_dr_rr(const int64_t ND, void *X, void *Y, void *Z,
+                        const int64_t NR, void *XR, void *YR, void *ZR,
+                        const int numthreads,
+                        const char *binfile,
+                        results_countpairs *dd, results_countpairs *dr, results_countpairs *rr,
+                        struct config_options *options,
+                        struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+            __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_dd_dr_rr_float(ND, (float *) X, (float *) Y, (float *) Z,
+                                         NR, (float *) XR, (float *) YR, (float *) ZR,
+                                         numthreads,
+                                         binfile,
+                                         dd, dr, rr,
+                                         options,
+                                         extra);
+    } else {
+        return countpairs_dd_dr_rr_double(ND, (double *) X, (double *) Y, (double *) Z,
+                                          NR, (double *) XR, (double *) YR, (double *) ZR,
+                                          numthreads,
+                                          binfile,
+                                          dd, dr, rr,
+                                          options,
+                                          extra);
+    }
+}
+
+
+int countpairs_prepared(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                        const int numthreads,
+                        const int autocorr,
+                        const char *binfile,
+                        results_countpairs *results,
+                        struct config_options *options,
+                        struct extra_options *extra)
+{
+    if(catalog1 == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    /* The precision is set by the catalog */
+    options->float_type = catalog1->float_type;
+    if(options->float_type == sizeof(float)) {
+        return countpairs_prepared_float(catalog1, catalog2,
+                                         numthreads,
+                                         autocorr,
+                                         binfile,
+                                         results,
+                                         options,
+                                         extra);
+    } else {
+        return countpairs_prepared_double(catalog1, catalog2,
+                                          numthreads,
+                                          autocorr,
+                                          binfile,
+                                          results,
+                                          options,
+                                          extra);
+    }
+}
+
+
+int countpairs_prepared_update(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                               const int numthreads,
+                               const int autocorr,
+                               const char *binfile,
+                               const int64_t ninsert, void *X1, void *Y1, void *Z1,
+                               const int64_t nremove, void *RX1, void *RY1, void *RZ1,
+                               results_countpairs_delta *results,
+                               struct config_options *options,
+                               struct extra_options *extra)
+{
+    if(catalog1 == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    /* The precision is set by the catalog */
+    options->float_type = catalog1->float_type;
+    if(options->float_type == sizeof(float)) {
+        return countpairs_prepared_update_float(catalog1, catalog2,
+                                                numthreads,
+                                                autocorr,
+                                                binfile,
+                                                ninsert, (float *) X1, (float *) Y1, (float *) Z1,
+                                                nremove, (float *) RX1, (float *) RY1, (float *) RZ1,
+                                                results,
+                                                options,
+                                                extra);
+    } else {
+        return countpairs_prepared_update_double(catalog1, catalog2,
+                                                 numthreads,
+                                                 autocorr,
+                                                 binfile,
+                                                 ninsert, (double *) X1, (double *) Y1, (double *) Z1,
+                                                 nremove, (double *) RX1, (double *) RY1, (double *) RZ1,
+                                                 results,
+                                                 options,
+                                                 extra);
+    }
+}
+
+
+
+int countpairs_slabs(particle_source *source1, particle_source *source2,
+                     const int numthreads,
+                     const int autocorr,
+                     const char *binfile,
+                     results_countpairs *results,
+                     struct config_options *options,
+                     struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+            __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_slabs_float(source1, source2,
+                                      numthreads,
+                                      autocorr,
+                                      binfile,
+                                      results,
+                                      options,
+                                      extra);
+    } else {
+        return countpairs_slabs_double(source1, source2,
+                                       numthreads,
+                                       autocorr,
+                                       binfile,
+                                       results,
+                                       options,
+                                       extra);
+    }
+}
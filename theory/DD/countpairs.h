@@ -14,6 +14,8 @@ extern "C" {
 
             
 #include "defs.h"//for struct config_options 
+#include "prepared_catalog.h"//for prepared_catalog
+#include "particle_source.h"//for particle_source
 #include <stdint.h> //for uint64_t
 
 //define the results structure
@@ -22,8 +24,20 @@ extern "C" {
     double *rupp;
     double *rpavg;
     double *weightavg;
+    uint64_t *region_npairs;/* pair counts for every pair of region labels (see region_labels.h). NULL without labels */
+    int nregions;
     int nbin;
   } results_countpairs;
+
+  /* Change in the results of countpairs. Holds the change in the sums of the separations (and of the pair
+     weights) rather than in their averages -> the averages are (sum + change)/(npairs + change in npairs) */
+  typedef struct{
+    int64_t *npairs;
+    double *rupp;
+    double *rpsum;
+    double *weightsum;
+    int nbin;
+  } results_countpairs_delta;
   
   extern int countpairs(const int64_t ND1, void *X1, void *Y1, void  *Z1,
                         const int64_t ND2, void *X2, void *Y2, void  *Z2,
@@ -33,8 +47,70 @@ extern "C" {
                         results_countpairs *results,
                         struct config_options *options,
                         struct extra_options *extra) __attribute__((warn_unused_result));
+
+  /* Pair counts for several bin specifications (one bin file each) from one pass over the pairs (see bin_specs.h).
+     results is an array with one entry for each of the nbinfiles bin files, and each entry is the same as from countpairs
+     with that bin file. The memory budget is not supported */
+  extern int countpairs_multi_bins(const int64_t ND1, void *X1, void *Y1, void *Z1,
+                                   const int64_t ND2, void *X2, void *Y2, void *Z2,
+                                   const int numthreads,
+                                   const int autocorr,
+                                   const int nbinfiles, const char **binfiles,
+                                   results_countpairs *results,
+                                   struct config_options *options,
+                                   struct extra_options *extra) __attribute__((warn_unused_result));
+
+  /* The DD, DR and RR pair counts (e.g., for the Landy-Szalay estimator) from a single walk over the cells. The data
+     (X/Y/Z, with the weights in extra->weights0) and the randoms (XR/YR/ZR, with the weights in extra->weights1) are
+     gridded once, on the same lattice. dd and rr are the same as the autocorrelations from countpairs, and dr is the
+     cross-correlation of the data with the randoms. Region labels, the memory budget and the kd-tree are not supported */
+  extern int countpairs_dd_dr_rr(const int64_t ND, void *X, void *Y, void *Z,
+                                 const int64_t NR, void *XR, void *YR, void *ZR,
+                                 const int numthreads,
+                                 const char *binfile,
+                                 results_countpairs *dd, results_countpairs *dr, results_countpairs *rr,
+                                 struct config_options *options,
+                                 struct extra_options *extra) __attribute__((warn_unused_result));
+
+  /* Same as countpairs but with catalogs that have already been gridded with prepare_catalog.
+     catalog2 is ignored (and may be NULL) for autocorrelations. */
+  extern int countpairs_prepared(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                                 const int numthreads,
+                                 const int autocorr,
+                                 const char *binfile,
+                                 results_countpairs *results,
+                                 struct config_options *options,
+                                 struct extra_options *extra) __attribute__((warn_unused_result));
+  
+  /* Updates catalog1 with update_prepared_catalog -> inserts the particles X1/Y1/Z1 (with the weights in extra->weights0)
+     and removes the particles at the positions RX1/RY1/RZ1. Returns the resulting change in the pair counts of the
+     autocorrelation of catalog1, or of its cross-correlation with catalog2 (which must be a different catalog). Only
+     the pairs of the inserted and removed particles are counted (against all the particles), so the cost scales
+     with the size of the change. catalog1 is left unchanged on failure */
+  extern int countpairs_prepared_update(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                                        const int numthreads,
+                                        const int autocorr,
+                                        const char *binfile,
+                                        const int64_t ninsert, void *X1, void *Y1, void *Z1,
+                                        const int64_t nremove, void *RX1, void *RY1, void *RZ1,
+                                        results_countpairs_delta *results,
+                                        struct config_options *options,
+                                        struct extra_options *extra) __attribute__((warn_unused_result));
+  
+  /* Same as countpairs but the particles are read from the sources (e.g., streamed from files with
+     open_particle_source in io.h) and counted one z-slab at a time so that the memory footprint stays
+     within options->memory_budget (which must be non-zero). The weights are also read from the
+     sources -> only extra->weight_method is used. source2 is ignored for autocorrelations. */
+  extern int countpairs_slabs(particle_source *source1, particle_source *source2,
+                              const int numthreads,
+                              const int autocorr,
+                              const char *binfile,
+                              results_countpairs *results,
+                              struct config_options *options,
+                              struct extra_options *extra) __attribute__((warn_unused_result));
   
   extern void free_results(results_countpairs *results);
+  extern void free_results_delta(results_countpairs_delta *results);
 
 #ifdef __cplusplus
 }
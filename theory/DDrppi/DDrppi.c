@@ -42,6 +42,10 @@
 
 
 void Printhelp(void);
+int DDrppi_streamed(const char *file1, const char *fileformat1, const char *weights_file1, const char *weights_fileformat1,
+                    const char *file2, const char *fileformat2, const char *weights_file2, const char *weights_fileformat2,
+                    const weight_method_t weight_method, const int num_weights,
+                    const int nthreads, const int autocorr, const char *binfile, const DOUBLE pimax, struct timeval t_start);
 
 int main(int argc, char *argv[])
 {
@@ -169,6 +173,12 @@ int main(int argc, char *argv[])
     }
     fprintf(stderr,"\t\t -------------------------------------\n");
 
+    /* With a memory budget (MEMORY_BUDGET in theory.options), the particles are streamed from the files */
+    if(get_config_options().memory_budget > 0) {
+        return DDrppi_streamed(file1, fileformat1, weights_file1, weights_fileformat1,
+                               file2, fileformat2, weights_file2, weights_fileformat2,
+                               weight_method, num_weights, nthreads, autocorr, binfile, pimax, t_start);
+    }
 
     gettimeofday(&t0,NULL);
     /*---Read-data1-file----------------------------------*/
@@ -280,6 +290,66 @@ int main(int argc, char *argv[])
     return EXIT_SUCCESS;
 }
 
+/*---Count-pairs-one-z-slab-at-a-time-----------------*/
+int DDrppi_streamed(const char *file1, const char *fileformat1, const char *weights_file1, const char *weights_fileformat1,
+                    const char *file2, const char *fileformat2, const char *weights_file2, const char *weights_fileformat2,
+                    const weight_method_t weight_method, const int num_weights,
+                    const int nthreads, const int autocorr, const char *binfile, const DOUBLE pimax, struct timeval t_start)
+{
+    struct timeval t_end,t0,t1;
+    particle_source source1, source2;
+    if(open_particle_source(&source1, file1, fileformat1, weights_file1, weights_fileformat1,
+                            weights_file1 != NULL ? num_weights:0, sizeof(DOUBLE)) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if(autocorr == 0 &&
+       open_particle_source(&source2, file2, fileformat2, weights_file2, weights_fileformat2,
+                            weights_file2 != NULL ? num_weights:0, sizeof(DOUBLE)) != EXIT_SUCCESS) {
+        close_particle_source(&source1);
+        return EXIT_FAILURE;
+    }
+
+    gettimeofday(&t0,NULL);
+    struct config_options options = get_config_options();
+    struct extra_options extra = get_extra_options(weight_method);
+    results_countpairs_rp_pi results;
+    int status = countpairs_rp_pi_slabs(&source1, autocorr ? &source1:&source2,
+                                        nthreads,
+                                        autocorr,
+                                        binfile,
+                                        pimax,
+                                        &results,
+                                        &options,
+                                        &extra);
+    const int64_t ND1 = source1.np;
+    const int64_t ND2 = autocorr ? source1.np:source2.np;
+    close_particle_source(&source1);
+    if(autocorr == 0) {
+        close_particle_source(&source2);
+    }
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+    gettimeofday(&t1,NULL);
+    double pair_time = ADD_DIFF_TIME(t0,t1);
+
+    const double dpi = pimax/(double)results.npibin ;
+    const int npibin = results.npibin;
+    for(int i=1;i<results.nbin;i++) {
+        const double logrp = LOG10(results.rupp[i]);
+        for(int j=0;j<npibin;j++) {
+            int index = i*(npibin+1) + j;
+            fprintf(stdout,"%e\t%e\t%e\t%12"PRIu64"\t%e\n",logrp, (j+1)*dpi, results.rpavg[index], results.npairs[index], results.weightavg[index]);
+        }
+    }
+
+    free_results_rp_pi(&results);
+    gettimeofday(&t_end,NULL);
+    fprintf(stderr,"DDrppi> Done -  ND1=%12"PRId64" ND2=%12"PRId64". Time taken = %6.2lf seconds (streamed the particles in z-slabs). pair-counting time = %6.2lf sec\n",
+            ND1,ND2,ADD_DIFF_TIME(t_start,t_end),pair_time);
+    return EXIT_SUCCESS;
+}
+
 /*---Print-help-information---------------------------*/
 void Printhelp(void)
 {
@@ -23,6 +23,7 @@ void free_results_rp_pi(results_countpairs_rp_pi *results)
     free(results->rupp);
     free(results->rpavg);
     free(results->weightavg);
+    free(results->region_npairs);
 }
 
 
@@ -69,3 +70,133 @@ int countpairs_rp_pi(const int64_t ND1, void *X1, void *Y1, void *Z1,
                                        extra);
     }
 }
+
+
+int countpairs_rp_pi_multi_bins(const int64_t ND1, void *X1, void *Y1, void *Z1,
+                                const int64_t ND2, void *X2, void *Y2, void *Z2,
+                                const int numthreads,
+                                const int autocorr,
+                                const int nbinfiles, const char **binfiles,
+                                const double pimax,
+                                results_countpairs_rp_pi *results,
+                                struct config_options *options,
+                                struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_rp_pi_multi_bins_float(ND1, (float *) X1, (float *) Y1, (float *) Z1,
+                                                 ND2, (float *) X2, (float *) Y2, (float *) Z2,
+                                                 numthreads,
+                                                 autocorr,
+                                                 nbinfiles, binfiles,
+                                                 pimax,
+                                                 results,
+                                                 options,
+                                                 extra);
+    } else {
+        return countpairs_rp_pi_multi_bins_double(ND1, (double *) X1, (double *) Y1, (double *) Z1,
+                                                  ND2, (double *) X2, (double *) Y2, (double *) Z2,
+                                                  numthreads,
+                                                  autocorr,
+                                                  nbinfiles, binfiles,
+                                                  pimax,
+                                                  results,
+                                                  options,
+                                                  extra);
+    }
+}
+
+
+int countpairs_rp_pi_prepared(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                              const int numthreads,
+                              const int autocorr,
+                              const char *binfile,
+                              const double pimax,
+                              results_countpairs_rp_pi *results,
+                              struct config_options *options,
+                              struct extra_options *extra)
+{
+    if(catalog1 == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    /* The precision is set by the catalog */
+    options->float_type = catalog1->float_type;
+    if(options->float_type == sizeof(float)) {
+        return countpairs_rp_pi_prepared_float(catalog1, catalog2,
+                                               numthreads,
+                                               autocorr,
+                                               binfile,
+                                               pimax,
+                                               results,
+                                               options,
+                                               extra);
+    } else {
+        return countpairs_rp_pi_prepared_double(catalog1, catalog2,
+                                                numthreads,
+                                                autocorr,
+                                                binfile,
+                                                pimax,
+                                                results,
+                                                options,
+                                                extra);
+    }
+}
+
+
+int countpairs_rp_pi_slabs(particle_source *source1, particle_source *source2,
+                           const int numthreads,
+                           const int autocorr,
+                           const char *binfile,
+                           const double pimax,
+                           results_countpairs_rp_pi *results,
+                           struct config_options *options,
+                           struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return countpairs_rp_pi_slabs_float(source1, source2,
+                                            numthreads,
+                                            autocorr,
+                                            binfile,
+                                            pimax,
+                                            results,
+                                            options,
+                                            extra);
+    } else {
+        return countpairs_rp_pi_slabs_double(source1, source2,
+                                             numthreads,
+                                             autocorr,
+                                             binfile,
+                                             pimax,
+                                             results,
+                                             options,
+                                             extra);
+    }
+}
@@ -13,6 +13,8 @@ extern "C" {
 #endif
 
 #include "defs.h" //for struct config_options 
+#include "prepared_catalog.h"//for prepared_catalog
+#include "particle_source.h"//for particle_source
 #include <stdint.h> //for uint64_t
 
     //define the results structure
@@ -21,7 +23,9 @@ extern "C" {
         double *rupp;
         double *rpavg;
         double *weightavg;
+        uint64_t *region_npairs;/* pair counts for every pair of region labels (see region_labels.h). NULL without labels */
         double pimax;
+        int nregions;
         int nbin;
         int npibin;
     } results_countpairs_rp_pi;
@@ -35,6 +39,42 @@ extern "C" {
                                 results_countpairs_rp_pi *results,
                                 struct config_options *options,
                                 struct extra_options *extra);
+
+    /* Pair counts for several rp bin specifications (one bin file each, with the same pimax) from one pass over
+       the pairs (see bin_specs.h). results holds one entry for each of the nbinfiles bin files. The memory budget
+       is not supported */
+    extern int countpairs_rp_pi_multi_bins(const int64_t ND1, void *X1, void *Y1, void *Z1,
+                                           const int64_t ND2, void *X2, void *Y2, void *Z2,
+                                           const int numthreads,
+                                           const int autocorr,
+                                           const int nbinfiles, const char **binfiles,
+                                           const double pimax,
+                                           results_countpairs_rp_pi *results,
+                                           struct config_options *options,
+                                           struct extra_options *extra);
+
+    /* Same as countpairs_rp_pi but with catalogs that have already been gridded with prepare_catalog
+       (with pimax at least as large as the pimax requested here). catalog2 is ignored (and may be NULL)
+       for autocorrelations. */
+    extern int countpairs_rp_pi_prepared(prepared_catalog *catalog1, prepared_catalog *catalog2,
+                                         const int numthreads,
+                                         const int autocorr,
+                                         const char *binfile,
+                                         const double pimax,
+                                         results_countpairs_rp_pi *results,
+                                         struct config_options *options,
+                                         struct extra_options *extra);
+    
+    /* Same as countpairs_rp_pi but the particles are read from the sources and counted one z-slab at a
+       time so that the memory footprint stays within options->memory_budget (see countpairs_slabs in DD) */
+    extern int countpairs_rp_pi_slabs(particle_source *source1, particle_source *source2,
+                                      const int numthreads,
+                                      const int autocorr,
+                                      const char *binfile,
+                                      const double pimax,
+                                      results_countpairs_rp_pi *results,
+                                      struct config_options *options,
+                                      struct extra_options *extra);
     
     extern void free_results_rp_pi(results_countpairs_rp_pi *results);
 
@@ -22,6 +22,7 @@
 #include "countpairs_rp_pi.h"
 #include "countpairs_wp.h"
 #include "countpairs_xi.h"
+#include "prepared_catalog.h"
 
 //for the vpf
 #include "countspheres.h"
@@ -75,6 +76,11 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
 static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *countpairs_countspheres_vpf(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *countpairs_prepare_catalog(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *countpairs_countpairs_prepared(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *countpairs_countpairs_rp_pi_prepared(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *countpairs_countpairs_wp_prepared(PyObject *self, PyObject *args, PyObject *kwargs);
+static PyObject *countpairs_countpairs_xi_prepared(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *countpairs_error_out(PyObject *module, const char *msg);
 
 /* Inline documentation for the methods so that help(function) has something reasonably useful*/
@@ -85,7 +91,9 @@ static PyMethodDef module_methods[] = {
      "           X2=None, Y2=None, Z2=None, weights2=None, verbose=False, boxsize=0.0,\n"
      "           output_ravg=False, xbin_refine_factor=2, ybin_refine_factor=2,\n"
      "           zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False,\n"
-     "           isa=-1)\n"
+     "           isa=-1, cell_ordering=0, use_kdtree=False,\n"
+     "           ngb_stencil=False, padded_cells=False,\n"
+     "           mixed_precision=False, autotune=False)\n"
      "\n"
      "Calculate the 3-D pair-counts, "XI_CHAR"(r), auto/cross-correlation \n"
      "function given two sets of points represented by X1/Y1/Z1 and X2/Y2/Z2 \n"
@@ -178,7 +186,38 @@ static PyMethodDef module_methods[] = {
      "  always leave ``isa`` to the default value. And if you *are* benchmarking,\n"
      "  then the integer values correspond to the ``enum`` for the instruction set\n"
      "  defined in ``utils/defs.h``.\n\n"
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "use_kdtree : boolean (default false)\n"
+     "  Replaces the lattice with a kd-tree, whose leaves are paired with a\n"
+     "  dual-tree walk. Faster for strongly clustered points. Requires the\n"
+     "  bins to be smaller than half the ``boxsize`` for periodic boundaries.\n\n"
        
+     "ngb_stencil : boolean (default false)\n"
+     "  Finds the neighbouring cells from a stencil of cell offsets shared by\n"
+     "  all the cells, instead of storing the neighbour cells (and periodic\n"
+     "  wraps) for every cell. Saves memory and setup time on large meshes;\n"
+     "  the results are identical.\n\n"
+     "padded_cells : boolean (default false)\n"
+     "  Pads every cell to a multiple of 64 bytes and aligns it to a cache\n"
+     "  line. The kernels are the same as for packed cells; the pair counts\n"
+     "  are identical.\n\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (ravg, weight_avg) are moved into double\n"
+     "  totals after every cell, so that they match a float64 run to a few\n"
+     "  parts in 10^6 on large catalogs. The pair counts are not affected.\n\n"
+     "autotune : boolean (default false)\n"
+     "  Ignored with custom bin refine factors. On the first call\n"
+     "  for this machine, statistic and (roughly) N and rmax/boxsize, times\n"
+     "  the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a\n"
+     "  subsample of the particles, and caches the fastest in the file in the\n"
+     "  ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (or\n"
+     "  ``~/.corrfunc_autotune``). Later calls use the cached settings.\n\n"
     "Returns\n"
     "--------\n\n"
     "A tuple (results, time) \n\n"
@@ -209,7 +248,9 @@ static PyMethodDef module_methods[] = {
      "countpairs_rp_pi(autocorr, nthreads, pimax, binfile, X1, Y1, Z1, weights1=None, weight_type=None,\n"
      "                 periodic=True, X2=None, Y2=None, Z2=None, weights2=None, verbose=False,\n"
      "                 boxsize=0.0, output_rpavg=False, xbin_refine_factor=2, ybin_refine_factor=2,\n"
-     "                 zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False, isa=-1)\n"
+     "                 zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False, isa=-1,\n"
+     "                 cell_ordering=0, use_kdtree=False,\n"
+     "                 ngb_stencil=False, mixed_precision=False, autotune=False)\n"
      "\n"
      "Calculate the 3-D pair-counts corresponding to the real-space correlation\n"
      "function, "XI_CHAR"("RP_CHAR", "PI_CHAR") or wp("RP_CHAR"). Pairs which are separated\n"
@@ -314,6 +355,33 @@ static PyMethodDef module_methods[] = {
      "  then the integer values correspond to the ``enum`` for the instruction set\n"
      "  defined in ``utils/defs.h``.\n"
      "\n"
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "use_kdtree : boolean (default false)\n"
+     "  Replaces the lattice with a kd-tree, whose leaves are paired with a\n"
+     "  dual-tree walk. Faster for strongly clustered points. Requires the\n"
+     "  bins to be smaller than half the ``boxsize`` for periodic boundaries.\n\n"
+     "ngb_stencil : boolean (default false)\n"
+     "  Finds the neighbouring cells from a stencil of cell offsets shared by\n"
+     "  all the cells, instead of storing the neighbour cells (and periodic\n"
+     "  wraps) for every cell. Saves memory and setup time on large meshes;\n"
+     "  the results are identical.\n\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (rpavg, weight_avg) are moved into double\n"
+     "  totals after every cell, so that they match a float64 run to a few\n"
+     "  parts in 10^6 on large catalogs. The pair counts are not affected.\n\n"
+     "autotune : boolean (default false)\n"
+     "  Ignored with custom bin refine factors. On the first call\n"
+     "  for this machine, statistic and (roughly) N and rmax/boxsize, times\n"
+     "  the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a\n"
+     "  subsample of the particles, and caches the fastest in the file in the\n"
+     "  ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (or\n"
+     "  ``~/.corrfunc_autotune``). Later calls use the cached settings.\n\n"
      "Returns\n"
      "--------\n"
      "\n"
@@ -347,7 +415,8 @@ static PyMethodDef module_methods[] = {
      "countpairs_wp(boxsize, pimax, nthreads, binfile, X, Y, Z, weights=None, weight_type=None, verbose=False,\n"
      "              output_rpavg=False, xbin_refine_factor=2, ybin_refine_factor=2,\n"
      "              zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False,\n"
-     "              c_cell_timer=False, isa=-1)\n"
+     "              c_cell_timer=False, isa=-1, cell_ordering=0, ngb_stencil=False,\n"
+     "              padded_cells=False, mixed_precision=False, autotune=False)\n"
      "\n"
      "Function to compute the projected correlation function in a periodic\n"
      "cosmological box. Pairs which are separated by less than the ``"RP_CHAR"``\n"
@@ -450,6 +519,33 @@ static PyMethodDef module_methods[] = {
      "  defined in ``utils/defs.h``.\n"
      "\n"
 
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "ngb_stencil : boolean (default false)\n"
+     "  Finds the neighbouring cells from a stencil of cell offsets shared by\n"
+     "  all the cells, instead of storing the neighbour cells (and periodic\n"
+     "  wraps) for every cell. Saves memory and setup time on large meshes;\n"
+     "  the results are identical.\n\n"
+     "padded_cells : boolean (default false)\n"
+     "  Pads every cell to a multiple of 64 bytes and aligns it to a cache\n"
+     "  line. The kernels are the same as for packed cells; the pair counts\n"
+     "  are identical.\n\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (rpavg, weight_avg) are moved into double\n"
+     "  totals after every cell, so that they match a float64 run to a few\n"
+     "  parts in 10^6 on large catalogs. The pair counts are not affected.\n\n"
+     "autotune : boolean (default false)\n"
+     "  Ignored with custom bin refine factors. On the first call\n"
+     "  for this machine, statistic and (roughly) N and rmax/boxsize, times\n"
+     "  the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a\n"
+     "  subsample of the particles, and caches the fastest in the file in the\n"
+     "  ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (or\n"
+     "  ``~/.corrfunc_autotune``). Later calls use the cached settings.\n\n"
      "Returns\n"
      "--------\n"
      "\n"
@@ -488,7 +584,8 @@ static PyMethodDef module_methods[] = {
     {"countpairs_xi"         ,(PyCFunction) countpairs_countpairs_xi    ,METH_VARARGS | METH_KEYWORDS,
      "countpairs_xi(boxsize, nthreads, binfile, X, Y, Z, weights=None, weight_type=None, verbose=False,\n"
      "              output_ravg=False, xbin_refine_factor=2, ybin_refine_factor=2,\n"
-     "              zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False, isa=-1)\n"
+     "              zbin_refine_factor=1, max_cells_per_dim=100, c_api_timer=False, isa=-1,\n"
+     "              cell_ordering=0, ngb_stencil=False, mixed_precision=False, autotune=False)\n"
      "\n"
      "Function to compute the projected correlation function in a periodic\n"
      "cosmological box. Pairs which are separated by less than the ``r``\n"
@@ -574,6 +671,29 @@ static PyMethodDef module_methods[] = {
      "  then the integer values correspond to the ``enum`` for the instruction set\n"
      "  defined in ``utils/defs.h``.\n"
      "\n"
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "ngb_stencil : boolean (default false)\n"
+     "  Finds the neighbouring cells from a stencil of cell offsets shared by\n"
+     "  all the cells, instead of storing the neighbour cells (and periodic\n"
+     "  wraps) for every cell. Saves memory and setup time on large meshes;\n"
+     "  the results are identical.\n\n"
+     "mixed_precision : boolean (default false)\n"
+     "  Only used for float32 arrays: the pairs are computed in float, but the\n"
+     "  sums for the averages (ravg, weight_avg) are moved into double\n"
+     "  totals after every cell, so that they match a float64 run to a few\n"
+     "  parts in 10^6 on large catalogs. The pair counts are not affected.\n\n"
+     "autotune : boolean (default false)\n"
+     "  Ignored with custom bin refine factors. On the first call\n"
+     "  for this machine, statistic and (roughly) N and rmax/boxsize, times\n"
+     "  the bin refine factors, ``max_cells_per_dim`` and ``isa`` on a\n"
+     "  subsample of the particles, and caches the fastest in the file in the\n"
+     "  ``CORRFUNC_AUTOTUNE_CACHE`` environment variable (or\n"
+     "  ``~/.corrfunc_autotune``). Later calls use the cached settings.\n\n"
      "Returns\n"
      "--------\n"
      "\n"
@@ -723,6 +843,91 @@ static PyMethodDef module_methods[] = {
      "                                         periodic=True)\n"
      "\n"
     },
+    {"prepare_catalog"       ,(PyCFunction) countpairs_prepare_catalog  ,METH_VARARGS | METH_KEYWORDS,
+     "prepare_catalog(rmax, pimax, nthreads, X, Y, Z, weights=None, weight_type=None,\n"
+     "                periodic=True, boxsize=0.0, verbose=False, xbin_refine_factor=2,\n"
+     "                ybin_refine_factor=2, zbin_refine_factor=1, max_cells_per_dim=100,\n"
+     "                isa=-1, cell_ordering=0)\n"
+     "\n"
+     "Grids (and sorts) the particles once so that they can be re-used across\n"
+     "calls to ``countpairs_prepared``, ``countpairs_rp_pi_prepared``,\n"
+     "``countpairs_wp_prepared`` and ``countpairs_xi_prepared``. The catalog keeps\n"
+     "its own copy of the particles.\n"
+     "\n"
+     "Parameters\n"
+     "-----------\n"
+     "rmax : double\n"
+     "   The largest separation (along x and y) that will be requested from the catalog\n"
+     "\n"
+     "pimax : double\n"
+     "   The largest separation along z that will be requested. Use ``pimax = rmax`` for\n"
+     "   ``countpairs_prepared`` and ``countpairs_xi_prepared``.\n"
+     "\n"
+     "The remaining parameters have the same meaning as in ``countpairs``. Two catalogs\n"
+     "can only be cross-correlated if they were prepared with identical grids, i.e., in\n"
+     "periodic mode with the same ``boxsize`` and bin refine factors.\n"
+     "\n"
+     "cell_ordering : integer (default 0)\n"
+     "  Controls the order in which the cells of the lattice are stored and\n"
+     "  traversed. Possible options are 0 (row-major), 1 (Morton) and 2 (Hilbert).\n"
+     "  The space-filling curve orderings keep neighbouring cells close in memory\n"
+     "  and can help the runtime on large meshes. Values correspond to the\n"
+     "  ``BINNING_ORD_*`` macros in ``utils/defs.h``.\n\n"
+     "Returns\n"
+     "--------\n"
+     "\n"
+     "catalog : an opaque object (PyCapsule) that frees the catalog when it is garbage collected.\n"
+     "   A catalog must not be used by two pair-counting calls at the same time.\n"
+     "\n"
+     "Example\n"
+     "--------\n"
+     "\n"
+     ">>> from _countpairs import prepare_catalog, countpairs_wp_prepared\n"
+     ">>> from Corrfunc.io import read_catalog\n"
+     ">>> x,y,z = read_catalog()\n"
+     ">>> boxsize = 420.0\n"
+     ">>> catalog = prepare_catalog(25.0, 40.0, 2, x, y, z, boxsize=boxsize)\n"
+     ">>> for pimax in [20.0, 40.0]:\n"
+     "...     (wp, time, cell_time) = countpairs_wp_prepared(boxsize, pimax, 2, '../tests/bins', catalog)\n"
+     "\n"
+    },
+    {"countpairs_prepared"   ,(PyCFunction) countpairs_countpairs_prepared ,METH_VARARGS | METH_KEYWORDS,
+     "countpairs_prepared(autocorr, nthreads, binfile, catalog1, catalog2=None, weight_type=None,\n"
+     "                    verbose=False, output_ravg=False, c_api_timer=False, isa=-1)\n"
+     "\n"
+     "Same as ``countpairs`` but with catalogs returned by ``prepare_catalog``.\n"
+     "``catalog2`` is only used for cross-correlations. Returns the same output as ``countpairs``.\n"
+     "\n"
+    },
+    {"countpairs_rp_pi_prepared",(PyCFunction) countpairs_countpairs_rp_pi_prepared ,METH_VARARGS | METH_KEYWORDS,
+     "countpairs_rp_pi_prepared(autocorr, nthreads, pimax, binfile, catalog1, catalog2=None,\n"
+     "                          weight_type=None, verbose=False, output_rpavg=False,\n"
+     "                          c_api_timer=False, isa=-1)\n"
+     "\n"
+     "Same as ``countpairs_rp_pi`` but with catalogs returned by ``prepare_catalog``.\n"
+     "``pimax`` must not exceed the ``pimax`` the catalogs were prepared with. Returns the\n"
+     "same output as ``countpairs_rp_pi``.\n"
+     "\n"
+    },
+    {"countpairs_wp_prepared",(PyCFunction) countpairs_countpairs_wp_prepared ,METH_VARARGS | METH_KEYWORDS,
+     "countpairs_wp_prepared(boxsize, pimax, nthreads, binfile, catalog, weight_type=None,\n"
+     "                       verbose=False, output_rpavg=False, c_api_timer=False,\n"
+     "                       c_cell_timer=False, isa=-1)\n"
+     "\n"
+     "Same as ``countpairs_wp`` but with a catalog returned by ``prepare_catalog``. The\n"
+     "catalog must have been prepared with ``periodic=True`` and the same ``boxsize``.\n"
+     "Returns the same output as ``countpairs_wp``.\n"
+     "\n"
+    },
+    {"countpairs_xi_prepared",(PyCFunction) countpairs_countpairs_xi_prepared ,METH_VARARGS | METH_KEYWORDS,
+     "countpairs_xi_prepared(boxsize, nthreads, binfile, catalog, weight_type=None,\n"
+     "                       verbose=False, output_ravg=False, c_api_timer=False, isa=-1)\n"
+     "\n"
+     "Same as ``countpairs_xi`` but with a catalog returned by ``prepare_catalog``. The\n"
+     "catalog must have been prepared with ``periodic=True`` and the same ``boxsize``.\n"
+     "Returns the same output as ``countpairs_xi``.\n"
+     "\n"
+    },
     {NULL, NULL, 0, NULL}
 };
 
@@ -955,6 +1160,9 @@ static PyObject *countpairs_countpairs(PyObject *self, PyObject *args, PyObject
     int8_t xbin_ref=options.bin_refine_factors[0],
         ybin_ref=options.bin_refine_factors[1],
         zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+    int8_t ngb_stencil=(get_ngb_scheme(&options) == BINNING_NGB_STENCIL);
+    int8_t padded_cells=(get_cell_layout(&options) == BINNING_LAY_PADDED);
 
     static char *kwlist[] = {
         "autocorr",
@@ -979,11 +1187,17 @@ static PyObject *countpairs_countpairs(PyObject *self, PyObject *args, PyObject
         "c_api_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
         "weight_type",
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        "use_kdtree",/* pair the leaves of a kd-tree instead of the cells of the lattice */
+        "ngb_stencil",/* find the neighbouring cells from a stencil shared by all cells, instead of storing them per cell */
+        "padded_cells",/* pad (and align) every cell to a multiple of 64 bytes */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
+        "autotune",/* time the binning and instruction set on a subsample, cached on disk (see utils/autotune.h) */
         NULL
     };
 
     // Note: type 'O!' doesn't allow for None to be passed, which we might want to do.
-    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iisO!O!O!|O!O!O!O!O!bbdbbbbhbis", kwlist,
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iisO!O!O!|O!O!O!O!O!bbdbbbbhbisbbbbbb", kwlist,
                                        &autocorr,&nthreads,&binfile,
                                        &PyArray_Type,&x1_obj,
                                        &PyArray_Type,&y1_obj,
@@ -1001,7 +1215,13 @@ static PyObject *countpairs_countpairs(PyObject *self, PyObject *args, PyObject
                                        &(options.max_cells_per_dim),
                                        &(options.c_api_timer),
                                        &(options.instruction_set),
-                                       &weighting_method_str)
+                                       &weighting_method_str,
+                                       &cell_ordering,
+                                       &(options.use_kdtree),
+                                       &ngb_stencil,
+                                       &padded_cells,
+                                       &(options.mixed_precision),
+                                       &(options.autotune))
 
          ) {
         
@@ -1035,6 +1255,9 @@ static PyObject *countpairs_countpairs(PyObject *self, PyObject *args, PyObject
         options.bin_refine_factors[2] = zbin_ref;
         set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
     }
+    set_cell_ordering(&options, cell_ordering);
+    set_ngb_scheme(&options, ngb_stencil ? BINNING_NGB_STENCIL:BINNING_NGB_LIST);
+    set_cell_layout(&options, padded_cells ? BINNING_LAY_PADDED:BINNING_LAY_PACKED);
 
     
     /* We have numpy arrays and all the required inputs*/
@@ -1063,6 +1286,14 @@ static PyObject *countpairs_countpairs(PyObject *self, PyObject *args, PyObject
         countpairs_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -1259,6 +1490,8 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
     int8_t xbin_ref=options.bin_refine_factors[0],
         ybin_ref=options.bin_refine_factors[1],
         zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+    int8_t ngb_stencil=(get_ngb_scheme(&options) == BINNING_NGB_STENCIL);
     
     static char *kwlist[] = {
         "autocorr",
@@ -1284,10 +1517,15 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
         "c_api_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
         "weight_type",
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        "use_kdtree",/* pair the leaves of a kd-tree instead of the cells of the lattice */
+        "ngb_stencil",/* find the neighbouring cells from a stencil shared by all cells, instead of storing them per cell */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
+        "autotune",/* time the binning and instruction set on a subsample, cached on disk (see utils/autotune.h) */
         NULL
     };
 
-    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iidsO!O!O!|O!O!O!O!O!bbdbbbbhbis", kwlist,
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iidsO!O!O!|O!O!O!O!O!bbdbbbbhbisbbbbb", kwlist,
                                        &autocorr,&nthreads,&pimax,&binfile,
                                        &PyArray_Type,&x1_obj,
                                        &PyArray_Type,&y1_obj,
@@ -1305,7 +1543,12 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
                                        &(options.max_cells_per_dim),
                                        &(options.c_api_timer),
                                        &(options.instruction_set),
-                                       &weighting_method_str)
+                                       &weighting_method_str,
+                                       &cell_ordering,
+                                       &(options.use_kdtree),
+                                       &ngb_stencil,
+                                       &(options.mixed_precision),
+                                       &(options.autotune))
 
          ) {
         PyObject_Print(kwargs, stdout, 0);
@@ -1338,6 +1581,8 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
         options.bin_refine_factors[2] = zbin_ref;
         set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
     }
+    set_cell_ordering(&options, cell_ordering);
+    set_ngb_scheme(&options, ngb_stencil ? BINNING_NGB_STENCIL:BINNING_NGB_LIST);
 
     size_t element_size;
     /* How many data points are there? And are they all of floating point type */
@@ -1364,6 +1609,14 @@ static PyObject *countpairs_countpairs_rp_pi(PyObject *self, PyObject *args, PyO
         countpairs_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -1560,6 +1813,9 @@ static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObje
     int8_t xbin_ref=options.bin_refine_factors[0],
         ybin_ref=options.bin_refine_factors[1],
         zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+    int8_t ngb_stencil=(get_ngb_scheme(&options) == BINNING_NGB_STENCIL);
+    int8_t padded_cells=(get_cell_layout(&options) == BINNING_LAY_PADDED);
     
     static char *kwlist[] = {
         "boxsize",
@@ -1580,10 +1836,15 @@ static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObje
         "c_api_timer",
         "c_cell_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        "ngb_stencil",/* find the neighbouring cells from a stencil shared by all cells, instead of storing them per cell */
+        "padded_cells",/* pad (and align) every cell to a multiple of 64 bytes */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
+        "autotune",/* time the binning and instruction set on a subsample, cached on disk (see utils/autotune.h) */
         NULL
     };
     
-    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "ddisO!O!O!|O!sbbbbbhbbi", kwlist,
+    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "ddisO!O!O!|O!sbbbbbhbbibbbbb", kwlist,
                                       &boxsize,&pimax,&nthreads,&binfile,
                                       &PyArray_Type,&x1_obj,
                                       &PyArray_Type,&y1_obj,
@@ -1596,7 +1857,12 @@ static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObje
                                       &(options.max_cells_per_dim),
                                       &(options.c_api_timer),
                                       &(options.c_cell_timer),
-                                      &(options.instruction_set))
+                                      &(options.instruction_set),
+                                      &cell_ordering,
+                                      &ngb_stencil,
+                                      &padded_cells,
+                                      &(options.mixed_precision),
+                                      &(options.autotune))
         
         ){
         PyObject_Print(kwargs, stdout, 0);
@@ -1630,6 +1896,9 @@ static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObje
         options.bin_refine_factors[2] = zbin_ref;
         set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
     }
+    set_cell_ordering(&options, cell_ordering);
+    set_ngb_scheme(&options, ngb_stencil ? BINNING_NGB_STENCIL:BINNING_NGB_LIST);
+    set_cell_layout(&options, padded_cells ? BINNING_LAY_PADDED:BINNING_LAY_PACKED);
     
     /* How many data points are there? And are they all of floating point type */
     const int64_t ND1 = check_dims_and_datatype(module, x1_obj, y1_obj, z1_obj, weights1_obj, &element_size);
@@ -1655,6 +1924,14 @@ static PyObject *countpairs_countpairs_wp(PyObject *self, PyObject *args, PyObje
         countpairs_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -1797,6 +2074,8 @@ static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObje
     int8_t xbin_ref=options.bin_refine_factors[0],
         ybin_ref=options.bin_refine_factors[1],
         zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+    int8_t ngb_stencil=(get_ngb_scheme(&options) == BINNING_NGB_STENCIL);
 
     static char *kwlist[] = {
         "boxsize",
@@ -1815,11 +2094,15 @@ static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObje
         "max_cells_per_dim",
         "c_api_timer",
         "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        "ngb_stencil",/* find the neighbouring cells from a stencil shared by all cells, instead of storing them per cell */
+        "mixed_precision",/* float arrays: sum the averages (ravg, weightavg) in double */
+        "autotune",/* time the binning and instruction set on a subsample, cached on disk (see utils/autotune.h) */
         NULL
     };
 
     
-    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "disO!O!O!|O!sbbbbbhbi", kwlist,
+    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "disO!O!O!|O!sbbbbbhbibbbb", kwlist,
                                       &boxsize,&nthreads,&binfile,
                                       &PyArray_Type,&x1_obj,
                                       &PyArray_Type,&y1_obj,
@@ -1831,7 +2114,11 @@ static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObje
                                       &xbin_ref, &ybin_ref, &zbin_ref,
                                       &(options.max_cells_per_dim),
                                       &(options.c_api_timer),
-                                      &(options.instruction_set))
+                                      &(options.instruction_set),
+                                      &cell_ordering,
+                                      &ngb_stencil,
+                                      &(options.mixed_precision),
+                                      &(options.autotune))
         ) {
 
         PyObject_Print(kwargs, stdout, 0);
@@ -1863,6 +2150,8 @@ static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObje
         options.bin_refine_factors[2] = zbin_ref;
         set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
     }
+    set_cell_ordering(&options, cell_ordering);
+    set_ngb_scheme(&options, ngb_stencil ? BINNING_NGB_STENCIL:BINNING_NGB_LIST);
 
 
     /* How many data points are there? And are they all of floating point type */
@@ -1890,6 +2179,14 @@ static PyObject *countpairs_countpairs_xi(PyObject *self, PyObject *args, PyObje
         countpairs_error_out(module, msg);
         Py_RETURN_NONE;
     }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
     int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
     struct extra_options extra = get_extra_options(weighting_method);
     if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
@@ -2162,3 +2459,797 @@ static PyObject *countpairs_countspheres_vpf(PyObject *self, PyObject *args, PyO
     free_results_countspheres(&results);
     return Py_BuildValue("(Od)", ret, c_api_time);
 }
+
+
+#define PREPARED_CATALOG_CAPSULE_NAME  "_countpairs.prepared_catalog"
+
+static void prepared_catalog_capsule_destructor(PyObject *capsule)
+{
+    prepared_catalog *catalog = (prepared_catalog *) PyCapsule_GetPointer(capsule, PREPARED_CATALOG_CAPSULE_NAME);
+    if(catalog == NULL) {
+        return;
+    }
+    free_prepared_catalog(catalog);
+    free(catalog);
+}
+
+/* Returns NULL (with the error already set) if the object is not a prepared catalog */
+static prepared_catalog *get_prepared_catalog(PyObject *module, PyObject *catalog_obj, const char *name)
+{
+    if(catalog_obj == NULL || ! PyCapsule_IsValid(catalog_obj, PREPARED_CATALOG_CAPSULE_NAME)) {
+        char msg[1024];
+        snprintf(msg, 1024, "TypeError: Expected `%s' to be a catalog returned by `prepare_catalog'", name);
+        countpairs_error_out(module, msg);
+        return NULL;
+    }
+    return (prepared_catalog *) PyCapsule_GetPointer(catalog_obj, PREPARED_CATALOG_CAPSULE_NAME);
+}
+
+
+static PyObject *countpairs_prepare_catalog(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if PY_MAJOR_VERSION < 3
+    (void) self;
+    PyObject *module = NULL;//should not be used -> setting to NULL so any attempts to dereference will result in a crash. 
+#else
+    //In python3, self is simply the module object that was returned earlier by init
+    PyObject *module = self;
+#endif    
+    PyArrayObject *x1_obj=NULL, *y1_obj=NULL, *z1_obj=NULL, *weights1_obj=NULL;
+    double rmax, pimax;
+    int nthreads=4;
+    char *weighting_method_str = NULL;
+
+    struct config_options options = get_config_options();
+    options.verbose = 0;
+    options.instruction_set = -1;
+    options.periodic = 1;
+    
+    int8_t xbin_ref=options.bin_refine_factors[0],
+        ybin_ref=options.bin_refine_factors[1],
+        zbin_ref=options.bin_refine_factors[2];
+    int8_t cell_ordering=get_cell_ordering(&options);
+
+    static char *kwlist[] = {
+        "rmax",
+        "pimax",
+        "nthreads",
+        "X",
+        "Y",
+        "Z",
+        "weights",
+        "weight_type",
+        "periodic",
+        "boxsize",
+        "verbose", /* keyword verbose -> print extra info at runtime + progressbar */
+        "xbin_refine_factor",
+        "ybin_refine_factor",
+        "zbin_refine_factor",
+        "max_cells_per_dim",
+        "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        "cell_ordering",/* 3-D -> 1-D conversion of the cell index; 0 (row-major), 1 (Morton) or 2 (Hilbert) */
+        NULL
+    };
+
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "ddiO!O!O!|O!sbdbbbbhib", kwlist,
+                                       &rmax, &pimax, &nthreads,
+                                       &PyArray_Type,&x1_obj,
+                                       &PyArray_Type,&y1_obj,
+                                       &PyArray_Type,&z1_obj,
+                                       &PyArray_Type,&weights1_obj,
+                                       &weighting_method_str,
+                                       &(options.periodic),
+                                       &(options.boxsize),
+                                       &(options.verbose),
+                                       &xbin_ref, &ybin_ref, &zbin_ref,
+                                       &(options.max_cells_per_dim),
+                                       &(options.instruction_set),
+                                       &cell_ordering)
+         ) {
+        PyObject_Print(kwargs, stdout, 0);
+        fprintf(stdout, "\n");
+
+        char msg[1024];
+        int len=snprintf(msg, 1024,"ArgumentError: In prepare_catalog> Could not parse the arguments. Input parameters are: \n");
+
+        /* How many keywords do we have? Subtract 1 because of the last NULL */
+        const size_t nitems = sizeof(kwlist)/sizeof(*kwlist) - 1;
+        int status = print_kwlist_into_msg(msg, 1024, len, kwlist, nitems);
+        if(status != EXIT_SUCCESS) {
+            fprintf(stderr,"Error message does not contain all of the keywords\n");
+        }
+        
+        countpairs_error_out(module,msg);
+        Py_RETURN_NONE;
+    }
+
+    /*This is for the fastest isa */
+    if(options.instruction_set == -1) {
+        options.instruction_set = highest_isa;
+    }
+
+    if(xbin_ref != options.bin_refine_factors[0] ||
+       ybin_ref != options.bin_refine_factors[1] ||
+       zbin_ref != options.bin_refine_factors[2]) {
+        options.bin_refine_factors[0] = xbin_ref;
+        options.bin_refine_factors[1] = ybin_ref;
+        options.bin_refine_factors[2] = zbin_ref;
+        set_bin_refine_scheme(&options, BINNING_CUST);//custom binning -> code will honor requested binning scheme
+    }
+    set_cell_ordering(&options, cell_ordering);
+
+    /* How many data points are there? And are they all of floating point type */
+    size_t element_size;
+    const int64_t ND1 = check_dims_and_datatype(module, x1_obj, y1_obj, z1_obj, weights1_obj, &element_size);
+    if(ND1 == -1) {
+        //Error has already been set -> simply return 
+        Py_RETURN_NONE;
+    }
+    
+    /* Ensure the weights are of the right shape (n_weights, n_particles) */
+    if(weights1_obj != NULL){
+        // A numpy dimension of length -1 will be expanded to n_weights
+        npy_intp dims[2] = {-1, ND1};
+        PyArray_Dims pdims = {.ptr = &(dims[0]), .len = 2};
+        weights1_obj = (PyArrayObject *) PyArray_Newshape(weights1_obj, &pdims, NPY_CORDER);
+    }
+    
+    /* Validate the user's choice of weighting method */
+    weight_method_t weighting_method;
+    int wstatus = get_weight_method_by_name(weighting_method_str, &weighting_method);
+    if(wstatus != EXIT_SUCCESS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: unknown weight_type %s!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    int found_weights = weights1_obj == NULL ? 0 : PyArray_SHAPE(weights1_obj)[0];
+    struct extra_options extra = get_extra_options(weighting_method);
+    if(extra.weights0.num_weights > 0 && extra.weights0.num_weights != found_weights){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: specified weighting method %s which requires %"PRId64" weight(s)-per-particle, but found %d weight(s) instead!\n",
+                 __FUNCTION__, weighting_method_str, extra.weights0.num_weights, found_weights);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+
+    if(extra.weights0.num_weights > 0 && found_weights > MAX_NUM_WEIGHTS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: Provided %d weights-per-particle, but the code was compiled with MAX_NUM_WEIGHTS=%d.\n",
+                 __FUNCTION__, found_weights, MAX_NUM_WEIGHTS);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+
+    /* Interpret the input objects as numpy arrays. */
+    const int requirements = NPY_ARRAY_IN_ARRAY;
+    PyObject *x1_array = NULL, *y1_array = NULL, *z1_array = NULL, *weights1_array = NULL;
+    x1_array = PyArray_FromArray(x1_obj, NOTYPE_DESCR, requirements);
+    y1_array = PyArray_FromArray(y1_obj, NOTYPE_DESCR, requirements);
+    z1_array = PyArray_FromArray(z1_obj, NOTYPE_DESCR, requirements);
+    if(weights1_obj != NULL){
+        weights1_array = PyArray_FromArray(weights1_obj, NOTYPE_DESCR, requirements);
+    }
+
+    if (x1_array == NULL || y1_array == NULL || z1_array == NULL) {
+        Py_XDECREF(x1_array);
+        Py_XDECREF(y1_array);
+        Py_XDECREF(z1_array);
+        Py_XDECREF(weights1_array);
+        char msg[1024];
+        snprintf(msg, 1024, "TypeError: In %s: Could not convert input array to allowed floating point types (doubles or floats). Are you passing numpy arrays?",
+                 __FUNCTION__);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+
+    /* Get pointers to the data as C-types. */
+    void *X1 = PyArray_DATA((PyArrayObject *) x1_array);
+    void *Y1 = PyArray_DATA((PyArrayObject *) y1_array);
+    void *Z1 = PyArray_DATA((PyArrayObject *) z1_array);
+    void *weights1 = NULL;
+    if(weights1_array != NULL){
+        weights1 = PyArray_DATA((PyArrayObject *) weights1_array);
+    }
+
+    /* Pack the weights into extra_options */
+    for(int64_t w = 0; w < extra.weights0.num_weights; w++){
+        extra.weights0.weights[w] = (char *) weights1 + w*ND1*element_size;
+    }
+
+    prepared_catalog *catalog = malloc(sizeof(*catalog));
+    if(catalog == NULL) {
+        Py_DECREF(x1_array);Py_DECREF(y1_array);Py_DECREF(z1_array);Py_XDECREF(weights1_array);
+        return PyErr_NoMemory();
+    }
+
+    NPY_BEGIN_THREADS_DEF;
+    NPY_BEGIN_THREADS;
+
+    options.float_type = element_size;
+    int status = prepare_catalog(ND1, X1, Y1, Z1,
+                                 rmax, pimax,
+                                 NULL,
+                                 nthreads,
+                                 catalog,
+                                 &options,
+                                 &extra);
+    NPY_END_THREADS;
+
+    /* Clean up. The catalog has its own copy of the particles */
+    Py_DECREF(x1_array);Py_DECREF(y1_array);Py_DECREF(z1_array);Py_XDECREF(weights1_array);
+
+    if(status != EXIT_SUCCESS) {
+        free(catalog);
+        Py_RETURN_NONE;
+    }
+
+    PyObject *capsule = PyCapsule_New(catalog, PREPARED_CATALOG_CAPSULE_NAME, prepared_catalog_capsule_destructor);
+    if(capsule == NULL) {
+        free_prepared_catalog(catalog);
+        free(catalog);
+    }
+    return capsule;
+}
+
+
+static PyObject *countpairs_countpairs_prepared(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if PY_MAJOR_VERSION < 3
+    (void) self;
+    PyObject *module = NULL;//should not be used -> setting to NULL so any attempts to dereference will result in a crash. 
+#else
+    //In python3, self is simply the module object that was returned earlier by init
+    PyObject *module = self;
+#endif    
+    PyObject *catalog1_obj = NULL, *catalog2_obj = NULL;
+    int autocorr=0;
+    int nthreads=4;
+    char *binfile, *weighting_method_str = NULL;
+
+    struct config_options options = get_config_options();
+    options.verbose = 0;
+    options.instruction_set = -1;
+    options.need_avg_sep = 0;
+    options.c_api_timer = 0;
+
+    static char *kwlist[] = {
+        "autocorr",
+        "nthreads",
+        "binfile",
+        "catalog1",
+        "catalog2",
+        "weight_type",
+        "verbose", /* keyword verbose -> print extra info at runtime + progressbar */
+        "output_ravg",
+        "c_api_timer",
+        "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        NULL
+    };
+
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iisO|Osbbbi", kwlist,
+                                       &autocorr,&nthreads,&binfile,
+                                       &catalog1_obj,
+                                       &catalog2_obj,
+                                       &weighting_method_str,
+                                       &(options.verbose),
+                                       &(options.need_avg_sep),
+                                       &(options.c_api_timer),
+                                       &(options.instruction_set))
+         ) {
+        PyObject_Print(kwargs, stdout, 0);
+        fprintf(stdout, "\n");
+
+        char msg[1024];
+        int len=snprintf(msg, 1024,"ArgumentError: In DD (prepared)> Could not parse the arguments. Input parameters are: \n");
+
+        /* How many keywords do we have? Subtract 1 because of the last NULL */
+        const size_t nitems = sizeof(kwlist)/sizeof(*kwlist) - 1;
+        int status = print_kwlist_into_msg(msg, 1024, len, kwlist, nitems);
+        if(status != EXIT_SUCCESS) {
+            fprintf(stderr,"Error message does not contain all of the keywords\n");
+        }
+        
+        countpairs_error_out(module,msg);
+        Py_RETURN_NONE;
+    }
+
+    /*This is for the fastest isa */
+    if(options.instruction_set == -1) {
+        options.instruction_set = highest_isa;
+    }
+
+    prepared_catalog *catalog1 = get_prepared_catalog(module, catalog1_obj, "catalog1");
+    if(catalog1 == NULL) {
+        Py_RETURN_NONE;
+    }
+    prepared_catalog *catalog2 = NULL;
+    if(autocorr == 0) {
+        catalog2 = get_prepared_catalog(module, catalog2_obj, "catalog2");
+        if(catalog2 == NULL) {
+            Py_RETURN_NONE;
+        }
+    }
+
+    /* Validate the user's choice of weighting method */
+    weight_method_t weighting_method;
+    int wstatus = get_weight_method_by_name(weighting_method_str, &weighting_method);
+    if(wstatus != EXIT_SUCCESS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: unknown weight_type %s!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    struct extra_options extra = get_extra_options(weighting_method);
+
+    NPY_BEGIN_THREADS_DEF;
+    NPY_BEGIN_THREADS;
+
+    results_countpairs results;
+    double c_api_time = 0.0;
+    int status = countpairs_prepared(catalog1, catalog2,
+                                     nthreads,
+                                     autocorr,
+                                     binfile,
+                                     &results,
+                                     &options,
+                                     &extra);
+    if(options.c_api_timer) {
+        c_api_time = options.c_api_time;
+    }
+    NPY_END_THREADS;
+
+    if(status != EXIT_SUCCESS) {
+        Py_RETURN_NONE;
+    }
+
+    /* Build the output list */
+    PyObject *ret = PyList_New(0);
+    double rlow=results.rupp[0];
+    for(int i=1;i<results.nbin;i++) {
+        PyObject *item = NULL;
+        const double rpavg = results.rpavg[i];
+        const double weight_avg = results.weightavg[i];
+        item = Py_BuildValue("(dddkd)", rlow,results.rupp[i],rpavg,results.npairs[i],weight_avg);
+        PyList_Append(ret, item);
+        Py_XDECREF(item);
+        rlow=results.rupp[i];
+    }
+
+    free_results(&results);
+    return Py_BuildValue("(Od)", ret, c_api_time);
+}
+
+
+static PyObject *countpairs_countpairs_rp_pi_prepared(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if PY_MAJOR_VERSION < 3
+    (void) self;
+    PyObject *module = NULL;//should not be used -> setting to NULL so any attempts to dereference will result in a crash. 
+#else
+    //In python3, self is simply the module object that was returned earlier by init
+    PyObject *module = self;
+#endif    
+    PyObject *catalog1_obj = NULL, *catalog2_obj = NULL;
+    int autocorr=0;
+    int nthreads=4;
+    double pimax;
+    char *binfile, *weighting_method_str = NULL;
+
+    struct config_options options = get_config_options();
+    options.verbose = 0;
+    options.instruction_set = -1;
+    options.need_avg_sep = 0;
+    options.c_api_timer = 0;
+
+    static char *kwlist[] = {
+        "autocorr",
+        "nthreads",
+        "pimax",
+        "binfile",
+        "catalog1",
+        "catalog2",
+        "weight_type",
+        "verbose", /* keyword verbose -> print extra info at runtime + progressbar */
+        "output_rpavg",
+        "c_api_timer",
+        "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        NULL
+    };
+
+    if ( ! PyArg_ParseTupleAndKeywords(args, kwargs, "iidsO|Osbbbi", kwlist,
+                                       &autocorr,&nthreads,&pimax,&binfile,
+                                       &catalog1_obj,
+                                       &catalog2_obj,
+                                       &weighting_method_str,
+                                       &(options.verbose),
+                                       &(options.need_avg_sep),
+                                       &(options.c_api_timer),
+                                       &(options.instruction_set))
+         ) {
+        PyObject_Print(kwargs, stdout, 0);
+        fprintf(stdout, "\n");
+
+        char msg[1024];
+        int len=snprintf(msg, 1024,"ArgumentError: In DDrppi (prepared)> Could not parse the arguments. Input parameters are: \n");
+
+        /* How many keywords do we have? Subtract 1 because of the last NULL */
+        const size_t nitems = sizeof(kwlist)/sizeof(*kwlist) - 1;
+        int status = print_kwlist_into_msg(msg, 1024, len, kwlist, nitems);
+        if(status != EXIT_SUCCESS) {
+            fprintf(stderr,"Error message does not contain all of the keywords\n");
+        }
+        
+        countpairs_error_out(module,msg);
+        Py_RETURN_NONE;
+    }
+
+    /*This is for the fastest isa */
+    if(options.instruction_set == -1) {
+        options.instruction_set = highest_isa;
+    }
+
+    prepared_catalog *catalog1 = get_prepared_catalog(module, catalog1_obj, "catalog1");
+    if(catalog1 == NULL) {
+        Py_RETURN_NONE;
+    }
+    prepared_catalog *catalog2 = NULL;
+    if(autocorr == 0) {
+        catalog2 = get_prepared_catalog(module, catalog2_obj, "catalog2");
+        if(catalog2 == NULL) {
+            Py_RETURN_NONE;
+        }
+    }
+
+    /* Validate the user's choice of weighting method */
+    weight_method_t weighting_method;
+    int wstatus = get_weight_method_by_name(weighting_method_str, &weighting_method);
+    if(wstatus != EXIT_SUCCESS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: unknown weight_type %s!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    struct extra_options extra = get_extra_options(weighting_method);
+
+    NPY_BEGIN_THREADS_DEF;
+    NPY_BEGIN_THREADS;
+
+    results_countpairs_rp_pi results;
+    double c_api_time = 0.0;
+    int status = countpairs_rp_pi_prepared(catalog1, catalog2,
+                                           nthreads,
+                                           autocorr,
+                                           binfile,
+                                           pimax,
+                                           &results,
+                                           &options,
+                                           &extra);
+    if(options.c_api_timer) {
+        c_api_time = options.c_api_time;
+    }
+    NPY_END_THREADS;
+
+    if(status != EXIT_SUCCESS) {
+        Py_RETURN_NONE;
+    }
+
+    /* Build the output list */
+    PyObject *ret = PyList_New(0);//create an empty list
+    double rlow=results.rupp[0];
+    const double dpi = pimax/(double)results.npibin ;
+
+    for(int i=1;i<results.nbin;i++) {
+        for(int j=0;j<results.npibin;j++) {
+            const int bin_index = i*(results.npibin + 1) + j;
+            PyObject *item = NULL;
+            const double rpavg = results.rpavg[bin_index];
+            const double weight_avg = results.weightavg[bin_index];
+            item = Py_BuildValue("(ddddkd)", rlow,results.rupp[i],rpavg,(j+1)*dpi,results.npairs[bin_index], weight_avg);
+            PyList_Append(ret, item);
+            Py_XDECREF(item);
+        }
+        rlow=results.rupp[i];
+    }
+    free_results_rp_pi(&results);
+    
+    return Py_BuildValue("(Od)", ret, c_api_time);
+}
+
+
+static PyObject *countpairs_countpairs_wp_prepared(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if PY_MAJOR_VERSION < 3
+    (void) self;
+    PyObject *module = NULL;//should not be used -> setting to NULL so any attempts to dereference will result in a crash. 
+#else
+    //In python3, self is simply the module object that was returned earlier by init
+    PyObject *module = self;
+#endif    
+    PyObject *catalog_obj = NULL;
+    double boxsize,pimax;
+    int nthreads=1;
+    char *binfile, *weighting_method_str = NULL;
+
+    struct config_options options = get_config_options();
+    options.verbose = 0;
+    options.instruction_set = -1;
+    options.need_avg_sep = 0;
+    options.periodic = 1;
+    options.c_api_timer = 0;
+    options.c_cell_timer = 0;
+
+    static char *kwlist[] = {
+        "boxsize",
+        "pimax",
+        "nthreads",
+        "binfile",
+        "catalog",
+        "weight_type",
+        "verbose", /* keyword verbose -> print extra info at runtime + progressbar */
+        "output_rpavg",
+        "c_api_timer",
+        "c_cell_timer",
+        "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        NULL
+    };
+
+    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "ddisO|sbbbbi", kwlist,
+                                      &boxsize,&pimax,&nthreads,&binfile,
+                                      &catalog_obj,
+                                      &weighting_method_str,
+                                      &(options.verbose),
+                                      &(options.need_avg_sep),
+                                      &(options.c_api_timer),
+                                      &(options.c_cell_timer),
+                                      &(options.instruction_set))
+        ){
+        PyObject_Print(kwargs, stdout, 0);
+        fprintf(stdout, "\n");
+
+        char msg[1024];
+        int len=snprintf(msg, 1024,"ArgumentError: In wp (prepared)> Could not parse the arguments. Input parameters are: \n");
+
+        /* How many keywords do we have? Subtract 1 because of the last NULL */
+        const size_t nitems = sizeof(kwlist)/sizeof(*kwlist) - 1;
+        int status = print_kwlist_into_msg(msg, 1024, len, kwlist, nitems);
+        if(status != EXIT_SUCCESS) {
+            fprintf(stderr,"Error message does not contain all of the keywords\n");
+        }
+        
+        countpairs_error_out(module,msg);
+        Py_RETURN_NONE;
+    }
+    options.boxsize=boxsize;
+
+    /*This is for the fastest isa */
+    if(options.instruction_set == -1) {
+        options.instruction_set = highest_isa;
+    }
+
+    prepared_catalog *catalog = get_prepared_catalog(module, catalog_obj, "catalog");
+    if(catalog == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    /* Validate the user's choice of weighting method */
+    weight_method_t weighting_method;
+    int wstatus = get_weight_method_by_name(weighting_method_str, &weighting_method);
+    if(wstatus != EXIT_SUCCESS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: unknown weight_type %s!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    struct extra_options extra = get_extra_options(weighting_method);
+
+    NPY_BEGIN_THREADS_DEF;
+    NPY_BEGIN_THREADS;
+
+    results_countpairs_wp results;
+    double c_api_time = 0.0;
+    int status = countpairs_wp_prepared(catalog,
+                                        boxsize,
+                                        nthreads,
+                                        binfile,
+                                        pimax,
+                                        &results,
+                                        &options,
+                                        &extra);
+    if(options.c_api_timer) {
+        c_api_time = options.c_api_time;
+    }
+    NPY_END_THREADS;
+
+    if(status != EXIT_SUCCESS) {
+        Py_RETURN_NONE;
+    }
+
+    /* Build the output list */
+    PyObject *ret = PyList_New(0);
+    double rlow=results.rupp[0];
+    for(int i=1;i<results.nbin;i++) {
+        PyObject *item = NULL;
+        const double rpavg = results.rpavg[i];
+        const double weight_avg = results.weightavg[i];
+        item = Py_BuildValue("(ddddkd)", rlow,results.rupp[i],rpavg,results.wp[i],results.npairs[i], weight_avg);
+        PyList_Append(ret, item);
+        Py_XDECREF(item);
+        rlow=results.rupp[i];
+    }
+    free_results_wp(&results);
+
+    PyObject *c_cell_time=PyList_New(0);
+    if(options.c_cell_timer) {
+        struct api_cell_timings *t = options.cell_timings;
+        for(int i=0;i<options.totncells_timings;i++) {
+            PyObject *item = Py_BuildValue("(kkkiii)", t->N1, t->N2, t->time_in_ns, t->first_cellindex, t->second_cellindex, t->tid);
+            PyList_Append(c_cell_time, item);
+            Py_XDECREF(item);
+            t++;
+        }
+        free_cell_timings(&options);
+    }
+    return Py_BuildValue("(OdO)", ret, c_api_time, c_cell_time);
+}
+
+
+static PyObject *countpairs_countpairs_xi_prepared(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+#if PY_MAJOR_VERSION < 3
+    (void) self;
+    PyObject *module = NULL;//should not be used -> setting to NULL so any attempts to dereference will result in a crash. 
+#else
+    //In python3, self is simply the module object that was returned earlier by init
+    PyObject *module = self;
+#endif    
+    PyObject *catalog_obj = NULL;
+    double boxsize;
+    int nthreads=4;
+    char *binfile, *weighting_method_str = NULL;
+
+    struct config_options options = get_config_options();
+    options.verbose = 0;
+    options.instruction_set = -1;
+    options.need_avg_sep = 0;
+    options.periodic = 1;
+    options.c_api_timer = 0;
+
+    static char *kwlist[] = {
+        "boxsize",
+        "nthreads",
+        "binfile",
+        "catalog",
+        "weight_type",
+        "verbose", /* keyword verbose -> print extra info at runtime + progressbar */
+        "output_ravg",
+        "c_api_timer",
+        "isa",/* instruction set to use of type enum isa; valid values are AVX, SSE, FALLBACK */
+        NULL
+    };
+
+    if( ! PyArg_ParseTupleAndKeywords(args, kwargs, "disO|sbbbi", kwlist,
+                                      &boxsize,&nthreads,&binfile,
+                                      &catalog_obj,
+                                      &weighting_method_str,
+                                      &(options.verbose),
+                                      &(options.need_avg_sep),
+                                      &(options.c_api_timer),
+                                      &(options.instruction_set))
+        ){
+        PyObject_Print(kwargs, stdout, 0);
+        fprintf(stdout, "\n");
+
+        char msg[1024];
+        int len=snprintf(msg, 1024,"ArgumentError: In xi (prepared)> Could not parse the arguments. Input parameters are: \n");
+
+        /* How many keywords do we have? Subtract 1 because of the last NULL */
+        const size_t nitems = sizeof(kwlist)/sizeof(*kwlist) - 1;
+        int status = print_kwlist_into_msg(msg, 1024, len, kwlist, nitems);
+        if(status != EXIT_SUCCESS) {
+            fprintf(stderr,"Error message does not contain all of the keywords\n");
+        }
+        
+        countpairs_error_out(module,msg);
+        Py_RETURN_NONE;
+    }
+    options.boxsize=boxsize;
+
+    /*This is for the fastest isa */
+    if(options.instruction_set == -1) {
+        options.instruction_set = highest_isa;
+    }
+
+    prepared_catalog *catalog = get_prepared_catalog(module, catalog_obj, "catalog");
+    if(catalog == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    /* Validate the user's choice of weighting method */
+    weight_method_t weighting_method;
+    int wstatus = get_weight_method_by_name(weighting_method_str, &weighting_method);
+    if(wstatus != EXIT_SUCCESS){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: unknown weight_type %s!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    /* The inverse bitwise and separation table weights need bitmasks and a separation table,
+       which are not passed through the python interface yet */
+    if(weighting_method == INVERSE_BITWISE || weighting_method == SEPARATION_TABLE){
+        char msg[1024];
+        snprintf(msg, 1024, "ValueError: In %s: weight_type %s is not supported from python yet!", __FUNCTION__, weighting_method_str);
+        countpairs_error_out(module, msg);
+        Py_RETURN_NONE;
+    }
+    struct extra_options extra = get_extra_options(weighting_method);
+
+    NPY_BEGIN_THREADS_DEF;
+    NPY_BEGIN_THREADS;
+
+    results_countpairs_xi results;
+    double c_api_time=0.0;
+    int status = countpairs_xi_prepared(catalog,
+                                        boxsize,
+                                        nthreads,
+                                        binfile,
+                                        &results,
+                                        &options,
+                                        &extra);
+    if(options.c_api_timer) {
+        c_api_time = options.c_api_time;
+    }
+    NPY_END_THREADS;
+
+    if(status != EXIT_SUCCESS) {
+        Py_RETURN_NONE;
+    }
+
+    /* Build the output list */
+    PyObject *ret = PyList_New(0);
+    double rlow=results.rupp[0];
+    for(int i=1;i<results.nbin;i++) {
+        PyObject *item = NULL;
+        const double ravg = results.ravg[i];
+        const double weight_avg = results.weightavg[i];
+        item = Py_BuildValue("(ddddkd)", rlow,results.rupp[i],ravg,results.xi[i],results.npairs[i], weight_avg);
+        PyList_Append(ret, item);
+        Py_XDECREF(item);
+        rlow=results.rupp[i];
+    }
+    free_results_xi(&results);
+
+    return Py_BuildValue("(Od)", ret, c_api_time);
+}
@@ -0,0 +1,1091 @@
+/* File: test_consistency.c */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/* Checks of the results against a reference that does not need a
+   stored output file: a brute-force count over all pairs, or the same
+   statistic computed through a different entry point. The catalogs are
+   generated here (uniform plus clustered points in a periodic box) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <inttypes.h>
+
+#ifndef MAXLEN
+#define MAXLEN 500
+#endif
+
+#include "defs.h"
+#include "utils.h"
+#include "cpu_features.h"
+#include "bin_lookup_double.h"
+
+#include "../DD/countpairs.h"
+#include "../wp/countpairs_wp.h"
+#include "../xi/countpairs_xi.h"
+
+int test_pip_weights(void);
+int test_separation_table_weights(void);
+int test_prepared(void);
+int test_kdtree(void);
+int test_slabs(void);
+int test_prepared_update(void);
+int test_regions(void);
+int test_dd_dr_rr(void);
+int test_multi_bins(void);
+int test_padded_cells(void);
+int test_bin_lookup(void);
+
+void generate_catalog(void);
+
+//Global variables
+#define NPART 3000
+#define NRAND 2000
+int ND1;
+double *X1=NULL,*Y1=NULL,*Z1=NULL,*weights1=NULL;
+int64_t *bitmasks1=NULL;
+
+//the randoms (uniform in the box)
+int ND2;
+double *X2=NULL,*Y2=NULL,*Z2=NULL,*weights2=NULL;
+
+char binfile[]="bins";
+char linear_binfile[]="bins_linear";
+double boxsize=100.0;
+#ifdef _OPENMP
+const int nthreads=4;
+#else
+const int nthreads=1;
+#endif
+
+struct config_options options;
+const double maxdiff = 1e-9;
+const double maxreldiff = 1e-6;
+
+/* Splits the box of the test into 4-5 z-slabs (memory_budget). Most of it is the lattice itself (~2 MB) */
+const uint64_t slab_memory_budget = 3500000;
+
+const int test_isa[] = {FALLBACK, SSE42, AVX, AVX512F};
+const char test_isa_names[][MAXLEN] = {"fallback", "SSE4.2", "AVX", "AVX512F"};
+const int ntest_isa = sizeof(test_isa)/sizeof(test_isa[0]);
+
+//end global variables
+
+/* Deterministic random numbers in [0, 1) -> the same catalog on every machine */
+static uint64_t rng_state = 12345;
+static uint64_t random_bits(void)
+{
+    rng_state = rng_state*6364136223846793005ULL + 1442695040888963407ULL;
+    return rng_state;
+}
+static double random_uniform(void)
+{
+    return (random_bits() >> 11)*(1.0/9007199254740992.0);
+}
+
+/* The periodic (minimum image) separation of particles i and j */
+static double periodic_separation(const int64_t i, const int64_t j)
+{
+    double d[3] = {fabs(X1[i] - X1[j]), fabs(Y1[i] - Y1[j]), fabs(Z1[i] - Z1[j])};
+    double sqr_r = 0.0;
+    for(int k=0;k<3;k++) {
+        if(d[k] > 0.5*boxsize) {
+            d[k] = boxsize - d[k];
+        }
+        sqr_r += d[k]*d[k];
+    }
+    return sqrt(sqr_r);
+}
+
+/* The bin of r in the bins of results (0 -> outside the bins) */
+static int find_bin(const double r, const results_countpairs *results)
+{
+    for(int k=1;k<results->nbin;k++) {
+        if(r >= results->rupp[k-1] && r < results->rupp[k]) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+/* The largest separation in the bins (the rmax to prepare the catalogs with) */
+static double get_rmax(void)
+{
+    double rmin, rmax;
+    int nbin;
+    double *rupp = NULL;
+    int status = setup_bins(binfile, &rmin, &rmax, &nbin, &rupp);
+    assert(status == EXIT_SUCCESS && "Read the bins");
+    (void) status;
+    free(rupp);
+    return rmax;
+}
+
+/* npairs must be identical and the averages equal to within the tolerances */
+static int compare_results(const char *name, const results_countpairs *expected, const results_countpairs *computed)
+{
+    if(expected->nbin != computed->nbin) {
+        fprintf(stderr,"Failed (%s). True nbin = %d Computed nbin = %d\n", name, expected->nbin, computed->nbin);
+        return EXIT_FAILURE;
+    }
+    for(int k=1;k<expected->nbin;k++) {
+        int rpavg_equal = AlmostEqualRelativeAndAbs_double(expected->rpavg[k], computed->rpavg[k], maxdiff, maxreldiff);
+        int weights_equal = AlmostEqualRelativeAndAbs_double(expected->weightavg[k], computed->weightavg[k], maxdiff, maxreldiff);
+        if(expected->npairs[k] != computed->npairs[k] || rpavg_equal != EXIT_SUCCESS || weights_equal != EXIT_SUCCESS) {
+            fprintf(stderr,"Failed (%s) in bin %d. True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n",
+                    name, k, expected->npairs[k], computed->npairs[k]);
+            fprintf(stderr,"Failed (%s) in bin %d. True rpavg = %e Computed rpavg = %e\n", name, k, expected->rpavg[k], computed->rpavg[k]);
+            fprintf(stderr,"Failed (%s) in bin %d. True weightavg = %e Computed weightavg = %e\n",
+                    name, k, expected->weightavg[k], computed->weightavg[k]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* The weighted DD of the catalog (autocorr) or of the catalog with the randoms */
+static int count_dd(const int autocorr, results_countpairs *results)
+{
+    struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+    extra.weights0.weights[0] = weights1;
+    extra.weights1.weights[0] = autocorr ? weights1:weights2;
+    return countpairs(ND1,X1,Y1,Z1,
+                      autocorr ? ND1:ND2, autocorr ? X1:X2, autocorr ? Y1:Y2, autocorr ? Z1:Z2,
+                      nthreads,
+                      autocorr,
+                      binfile,
+                      results,
+                      &options,
+                      &extra);
+}
+
+/* The periodic autocorrelation DD of the catalog, for every instruction set, with and without the average separations
+   and with and without the weights in extra, against the npairs, the average separation and the average of
+   pair_weight(i, j) over all the (ordered) pairs of particles in each bin */
+static int check_against_brute_force(const char *name, struct extra_options *extra, double (*pair_weight)(const int64_t, const int64_t))
+{
+    results_countpairs results;
+    int status = countpairs(ND1,X1,Y1,Z1,
+                            ND1,X1,Y1,Z1,
+                            nthreads,
+                            1,
+                            binfile,
+                            &results,
+                            &options,
+                            extra);
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+    const int nbin = results.nbin;
+    uint64_t npairs[nbin];
+    double rpavg[nbin], weightavg[nbin];
+    for(int k=0;k<nbin;k++) {
+        npairs[k] = 0;
+        rpavg[k] = 0.0;
+        weightavg[k] = 0.0;
+    }
+    for(int64_t i=0;i<ND1;i++) {
+        for(int64_t j=0;j<ND1;j++) {
+            if(i == j) continue;
+            const double r = periodic_separation(i, j);
+            const int k = find_bin(r, &results);
+            if(k == 0) continue;
+            npairs[k]++;
+            rpavg[k] += r;
+            weightavg[k] += pair_weight(i, j);
+        }
+    }
+    for(int k=1;k<nbin;k++) {
+        if(npairs[k] > 0) {
+            rpavg[k] /= (double) npairs[k];
+            weightavg[k] /= (double) npairs[k];
+        }
+    }
+    free_results(&results);
+
+    int ret = EXIT_SUCCESS;
+    const int save_isa = options.instruction_set;
+    const uint8_t save_need_avg_sep = options.need_avg_sep;
+    struct extra_options unweighted = get_extra_options(NONE);
+    for(int iset=0;iset<ntest_isa && ret == EXIT_SUCCESS;iset++) {
+        for(int need_avg_sep=0;need_avg_sep<2 && ret == EXIT_SUCCESS;need_avg_sep++) {
+            for(int weighted=0;weighted<2;weighted++) {
+                options.instruction_set = test_isa[iset];
+                options.need_avg_sep = need_avg_sep;
+                status = countpairs(ND1,X1,Y1,Z1,
+                                    ND1,X1,Y1,Z1,
+                                    nthreads,
+                                    1,
+                                    binfile,
+                                    &results,
+                                    &options,
+                                    weighted ? extra:&unweighted);
+                if(status != EXIT_SUCCESS) {
+                    ret = status;
+                    break;
+                }
+                //without the average separations (weights) the averages must be 0
+                for(int k=1;k<nbin;k++) {
+                    const double expected_rpavg = need_avg_sep ? rpavg[k]:0.0;
+                    const double expected_weightavg = weighted ? weightavg[k]:0.0;
+                    int rpavg_equal = AlmostEqualRelativeAndAbs_double(expected_rpavg, results.rpavg[k], maxdiff, maxreldiff);
+                    int weights_equal = AlmostEqualRelativeAndAbs_double(expected_weightavg, results.weightavg[k], maxdiff, maxreldiff);
+                    if(npairs[k] != results.npairs[k] || rpavg_equal != EXIT_SUCCESS || weights_equal != EXIT_SUCCESS) {
+                        fprintf(stderr,"Failed (%s, %s, need_avg_sep = %d, weighted = %d) in bin %d. True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n",
+                                name, test_isa_names[iset], need_avg_sep, weighted, k, npairs[k], results.npairs[k]);
+                        fprintf(stderr,"Failed (%s, %s, need_avg_sep = %d, weighted = %d) in bin %d. True rpavg = %e Computed rpavg = %e\n",
+                                name, test_isa_names[iset], need_avg_sep, weighted, k, expected_rpavg, results.rpavg[k]);
+                        fprintf(stderr,"Failed (%s, %s, need_avg_sep = %d, weighted = %d) in bin %d. True weightavg = %e Computed weightavg = %e\n",
+                                name, test_isa_names[iset], need_avg_sep, weighted, k, expected_weightavg, results.weightavg[k]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+                free_results(&results);
+                if(ret != EXIT_SUCCESS) {
+                    break;
+                }
+            }
+        }
+    }
+    options.instruction_set = save_isa;
+    options.need_avg_sep = save_need_avg_sep;
+    return ret;
+}
+
+/* The PIP weight of the test, written out: 64 realizations over the number of realizations with both particles
+   selected (default_value when there are none), times the product of the second weights */
+static double pip_weight(const int64_t i, const int64_t j)
+{
+    const int nbits = __builtin_popcountll((unsigned long long) (bitmasks1[i] & bitmasks1[j]));
+    const double pip = nbits > 0 ? 64.0/nbits : 0.5;
+    return pip*weights1[i]*weights1[j];
+}
+
+int test_pip_weights(void)
+{
+    struct extra_options extra = get_extra_options(INVERSE_BITWISE);
+    extra.weights0.num_weights = 2;
+    extra.weights0.num_integer_weights = 1;
+    extra.weights0.weights[0] = bitmasks1;
+    extra.weights0.weights[1] = weights1;
+    extra.weights1 = extra.weights0;
+    extra.pair_weight.noffset = 0;
+    extra.pair_weight.nrealizations = 64;
+    extra.pair_weight.default_value = 0.5;
+
+    return check_against_brute_force("pip", &extra, pip_weight);
+}
+
+/* The separation table of the test: 1 below 1 and above 16, and linear in between the points by hand */
+#define NUM_TEST_SEP 4
+const double test_sep[NUM_TEST_SEP] = {1.0, 4.0, 8.0, 16.0};
+const double test_sep_weight[NUM_TEST_SEP] = {3.0, 2.0, 0.0, 1.0};
+
+static double table_weight(const int64_t i, const int64_t j)
+{
+    const double r = periodic_separation(i, j);
+    double factor = 1.0;
+    if(r >= 1.0 && r < 4.0) {
+        factor = 3.0 - (r - 1.0)/3.0;
+    } else if(r >= 4.0 && r < 8.0) {
+        factor = 2.0 - (r - 4.0)/2.0;
+    } else if(r >= 8.0 && r <= 16.0) {
+        factor = (r - 8.0)/8.0;
+    }
+    return factor*weights1[i]*weights1[j];
+}
+
+int test_separation_table_weights(void)
+{
+    struct extra_options extra = get_extra_options(SEPARATION_TABLE);
+    extra.weights0.weights[0] = weights1;
+    extra.weights1 = extra.weights0;
+    extra.pair_weight.num_sep = NUM_TEST_SEP;
+    extra.pair_weight.sep = test_sep;
+    extra.pair_weight.sep_weight = test_sep_weight;
+
+    return check_against_brute_force("separation table", &extra, table_weight);
+}
+
+/* DD (auto and cross) and xi from prepared catalogs against the same counts from the particles */
+int test_prepared(void)
+{
+    const double rmax = get_rmax();
+    struct extra_options extra1 = get_extra_options(PAIR_PRODUCT);
+    extra1.weights0.weights[0] = weights1;
+    struct extra_options extra2 = get_extra_options(PAIR_PRODUCT);
+    extra2.weights0.weights[0] = weights2;
+    prepared_catalog catalog1, catalog2;
+    int status = prepare_catalog(ND1, X1, Y1, Z1, rmax, rmax, NULL, nthreads, &catalog1, &options, &extra1);
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+    status = prepare_catalog(ND2, X2, Y2, Z2, rmax, rmax, NULL, nthreads, &catalog2, &options, &extra2);
+    if(status != EXIT_SUCCESS) {
+        free_prepared_catalog(&catalog1);
+        return status;
+    }
+
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        results_countpairs expected, results;
+        ret = count_dd(autocorr, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        // The weights are in the catalogs -> extra only gives the weighting method
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        ret = countpairs_prepared(&catalog1, &catalog2, nthreads, autocorr, binfile, &results, &options, &extra);
+        if(ret == EXIT_SUCCESS) {
+            ret = compare_results(autocorr ? "prepared DD (auto)":"prepared DD (cross)", &expected, &results);
+            free_results(&results);
+        }
+        free_results(&expected);
+    }
+
+    if(ret == EXIT_SUCCESS) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        extra.weights0.weights[0] = weights1;
+        results_countpairs_xi expected, results;
+        ret = countpairs_xi(ND1, X1, Y1, Z1, boxsize, nthreads, binfile, &expected, &options, &extra);
+        if(ret == EXIT_SUCCESS) {
+            struct extra_options extra_prepared = get_extra_options(PAIR_PRODUCT);
+            ret = countpairs_xi_prepared(&catalog1, boxsize, nthreads, binfile, &results, &options, &extra_prepared);
+            if(ret == EXIT_SUCCESS) {
+                for(int k=1;k<expected.nbin;k++) {
+                    if(expected.npairs[k] != results.npairs[k] ||
+                       AlmostEqualRelativeAndAbs_double(expected.xi[k], results.xi[k], maxdiff, maxreldiff) != EXIT_SUCCESS ||
+                       AlmostEqualRelativeAndAbs_double(expected.weightavg[k], results.weightavg[k], maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                        fprintf(stderr,"Failed (prepared xi) in bin %d. True npairs = %"PRIu64 " xi = %e Computed npairs = %"PRIu64" xi = %e\n",
+                                k, expected.npairs[k], expected.xi[k], results.npairs[k], results.xi[k]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+                free_results_xi(&results);
+            }
+            free_results_xi(&expected);
+        }
+    }
+
+    free_prepared_catalog(&catalog1);
+    free_prepared_catalog(&catalog2);
+    return ret;
+}
+
+/* DD (auto and cross, periodic and not) from the kd-tree against the lattice */
+int test_kdtree(void)
+{
+    int ret = EXIT_SUCCESS;
+    const int save_periodic = options.periodic;
+    for(int periodic=0;periodic<2 && ret == EXIT_SUCCESS;periodic++) {
+        for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+            options.periodic = periodic;
+            results_countpairs expected, results;
+            ret = count_dd(autocorr, &expected);
+            if(ret != EXIT_SUCCESS) {
+                break;
+            }
+            options.use_kdtree = 1;
+            ret = count_dd(autocorr, &results);
+            options.use_kdtree = 0;
+            if(ret == EXIT_SUCCESS) {
+                char name[MAXLEN];
+                my_snprintf(name, MAXLEN, "kd-tree DD (periodic = %d, autocorr = %d)", periodic, autocorr);
+                ret = compare_results(name, &expected, &results);
+                free_results(&results);
+            }
+            free_results(&expected);
+        }
+    }
+    options.periodic = save_periodic;
+    return ret;
+}
+
+/* DD (auto and cross) and wp counted in z-slabs within a memory budget, from the arrays and from particle sources,
+   against the counts without a budget */
+int test_slabs(void)
+{
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        results_countpairs expected, results;
+        ret = count_dd(autocorr, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        options.memory_budget = slab_memory_budget;
+        ret = count_dd(autocorr, &results);
+        if(ret == EXIT_SUCCESS) {
+            ret = compare_results(autocorr ? "DD in slabs (auto)":"DD in slabs (cross)", &expected, &results);
+            free_results(&results);
+        }
+
+        if(ret == EXIT_SUCCESS) {
+            struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+            extra.weights0.weights[0] = weights1;
+            extra.weights1.weights[0] = weights2;
+            particle_source source1, source2;
+            ret = init_particle_source_arrays(&source1, ND1, X1, Y1, Z1, &(extra.weights0), sizeof(double));
+            if(ret == EXIT_SUCCESS) {
+                ret = init_particle_source_arrays(&source2, ND2, X2, Y2, Z2, &(extra.weights1), sizeof(double));
+                if(ret == EXIT_SUCCESS) {
+                    ret = countpairs_slabs(&source1, &source2, nthreads, autocorr, binfile, &results, &options, &extra);
+                    if(ret == EXIT_SUCCESS) {
+                        ret = compare_results(autocorr ? "DD from particle sources (auto)":"DD from particle sources (cross)", &expected, &results);
+                        free_results(&results);
+                    }
+                    close_particle_source(&source2);
+                }
+                close_particle_source(&source1);
+            }
+        }
+        options.memory_budget = 0;
+        free_results(&expected);
+    }
+
+    if(ret == EXIT_SUCCESS) {
+        const double pimax = 20.0;
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        extra.weights0.weights[0] = weights1;
+        results_countpairs_wp expected, results;
+        ret = countpairs_wp(ND1, X1, Y1, Z1, boxsize, nthreads, binfile, pimax, &expected, &options, &extra);
+        if(ret == EXIT_SUCCESS) {
+            options.memory_budget = slab_memory_budget;
+            ret = countpairs_wp(ND1, X1, Y1, Z1, boxsize, nthreads, binfile, pimax, &results, &options, &extra);
+            options.memory_budget = 0;
+            if(ret == EXIT_SUCCESS) {
+                for(int k=1;k<expected.nbin;k++) {
+                    if(expected.npairs[k] != results.npairs[k] ||
+                       AlmostEqualRelativeAndAbs_double(expected.wp[k], results.wp[k], maxdiff, maxreldiff) != EXIT_SUCCESS ||
+                       AlmostEqualRelativeAndAbs_double(expected.weightavg[k], results.weightavg[k], maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                        fprintf(stderr,"Failed (wp in slabs) in bin %d. True npairs = %"PRIu64 " wp = %e Computed npairs = %"PRIu64" wp = %e\n",
+                                k, expected.npairs[k], expected.wp[k], results.npairs[k], results.wp[k]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+                free_results_wp(&results);
+            }
+            free_results_wp(&expected);
+        }
+    }
+    return ret;
+}
+
+/* Updates a prepared catalog of the particles [0, ND1 - ninsert) by removing the first nremove particles and inserting
+   the last ninsert. The counts before the update plus the change from countpairs_prepared_update, and the counts from
+   the updated catalog, against a fresh count of the particles [nremove, ND1). For the autocorrelation and the
+   cross-correlation with the randoms */
+int test_prepared_update(void)
+{
+    const int64_t ninsert = 150, nremove = 100;
+    const int64_t nstart = ND1 - ninsert;
+    const double rmax = get_rmax();
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra1 = get_extra_options(PAIR_PRODUCT);
+        extra1.weights0.weights[0] = weights1;
+        struct extra_options extra2 = get_extra_options(PAIR_PRODUCT);
+        extra2.weights0.weights[0] = weights2;
+        prepared_catalog catalog1, catalog2;
+        ret = prepare_catalog(nstart, X1, Y1, Z1, rmax, rmax, NULL, nthreads, &catalog1, &options, &extra1);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        ret = prepare_catalog(ND2, X2, Y2, Z2, rmax, rmax, NULL, nthreads, &catalog2, &options, &extra2);
+        if(ret != EXIT_SUCCESS) {
+            free_prepared_catalog(&catalog1);
+            break;
+        }
+
+        results_countpairs before, after, expected;
+        results_countpairs_delta delta;
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        ret = countpairs_prepared(&catalog1, &catalog2, nthreads, autocorr, binfile, &before, &options, &extra);
+        if(ret == EXIT_SUCCESS) {
+            // the weights of the inserted particles
+            struct extra_options extra_insert = get_extra_options(PAIR_PRODUCT);
+            extra_insert.weights0.weights[0] = weights1 + nstart;
+            ret = countpairs_prepared_update(&catalog1, &catalog2, nthreads, autocorr, binfile,
+                                             ninsert, X1 + nstart, Y1 + nstart, Z1 + nstart,
+                                             nremove, X1, Y1, Z1,
+                                             &delta, &options, &extra_insert);
+            if(ret == EXIT_SUCCESS) {
+                struct extra_options extra_fresh = get_extra_options(PAIR_PRODUCT);
+                extra_fresh.weights0.weights[0] = weights1 + nremove;
+                extra_fresh.weights1.weights[0] = autocorr ? weights1 + nremove:weights2;
+                ret = countpairs(ND1 - nremove, X1 + nremove, Y1 + nremove, Z1 + nremove,
+                                 autocorr ? ND1 - nremove:ND2, autocorr ? X1 + nremove:X2, autocorr ? Y1 + nremove:Y2, autocorr ? Z1 + nremove:Z2,
+                                 nthreads, autocorr, binfile, &expected, &options, &extra_fresh);
+                if(ret == EXIT_SUCCESS) {
+                    for(int k=1;k<expected.nbin;k++) {
+                        const int64_t npairs = (int64_t) before.npairs[k] + delta.npairs[k];
+                        const double rpavg = npairs > 0 ? (before.rpavg[k]*before.npairs[k] + delta.rpsum[k])/npairs:0.0;
+                        const double weightavg = npairs > 0 ? (before.weightavg[k]*before.npairs[k] + delta.weightsum[k])/npairs:0.0;
+                        if(npairs != (int64_t) expected.npairs[k] ||
+                           AlmostEqualRelativeAndAbs_double(expected.rpavg[k], rpavg, maxdiff, maxreldiff) != EXIT_SUCCESS ||
+                           AlmostEqualRelativeAndAbs_double(expected.weightavg[k], weightavg, maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                            fprintf(stderr,"Failed (update, autocorr = %d) in bin %d. True npairs = %"PRIu64" rpavg = %e weightavg = %e "
+                                    "Computed npairs = %"PRId64" rpavg = %e weightavg = %e\n",
+                                    autocorr, k, expected.npairs[k], expected.rpavg[k], expected.weightavg[k], npairs, rpavg, weightavg);
+                            ret = EXIT_FAILURE;
+                            break;
+                        }
+                    }
+                    if(ret == EXIT_SUCCESS) {
+                        ret = countpairs_prepared(&catalog1, &catalog2, nthreads, autocorr, binfile, &after, &options, &extra);
+                        if(ret == EXIT_SUCCESS) {
+                            ret = compare_results(autocorr ? "updated catalog (auto)":"updated catalog (cross)", &expected, &after);
+                            free_results(&after);
+                        }
+                    }
+                    free_results(&expected);
+                }
+                free_results_delta(&delta);
+            }
+            free_results(&before);
+        }
+        free_prepared_catalog(&catalog1);
+        free_prepared_catalog(&catalog2);
+    }
+    return ret;
+}
+
+/* DD with region labels (4 slices in x): the pair counts summed over the pairs of regions against the totals, the
+   totals against the counts without labels, and the pairs within a region against the autocorrelation of that region */
+int test_regions(void)
+{
+    const int32_t nregions = 4;
+    int32_t *regions1 = my_malloc(sizeof(*regions1), ND1);
+    int32_t *regions2 = my_malloc(sizeof(*regions2), ND2);
+    double *rx = my_malloc(sizeof(*rx), ND1), *ry = my_malloc(sizeof(*ry), ND1), *rz = my_malloc(sizeof(*rz), ND1), *rw = my_malloc(sizeof(*rw), ND1);
+    if(regions1 == NULL || regions2 == NULL || rx == NULL || ry == NULL || rz == NULL || rw == NULL) {
+        free(regions1);free(regions2);free(rx);free(ry);free(rz);free(rw);
+        return EXIT_FAILURE;
+    }
+    for(int64_t i=0;i<ND1;i++) {
+        regions1[i] = (int32_t) (X1[i]*nregions/boxsize);
+    }
+    for(int64_t i=0;i<ND2;i++) {
+        regions2[i] = (int32_t) (X2[i]*nregions/boxsize);
+    }
+
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        results_countpairs expected, results;
+        ret = count_dd(autocorr, &expected);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        extra.weights0.weights[0] = weights1;
+        extra.weights1.weights[0] = autocorr ? weights1:weights2;
+        extra.nregions = nregions;
+        extra.regions0 = regions1;
+        extra.regions1 = autocorr ? regions1:regions2;
+        ret = countpairs(ND1,X1,Y1,Z1,
+                         autocorr ? ND1:ND2, autocorr ? X1:X2, autocorr ? Y1:Y2, autocorr ? Z1:Z2,
+                         nthreads, autocorr, binfile, &results, &options, &extra);
+        if(ret != EXIT_SUCCESS) {
+            free_results(&expected);
+            break;
+        }
+        ret = compare_results(autocorr ? "DD with regions (auto)":"DD with regions (cross)", &expected, &results);
+        const int nbin = results.nbin;
+        for(int k=1;k<nbin && ret == EXIT_SUCCESS;k++) {
+            uint64_t npairs = 0;
+            for(int r=0;r<nregions*nregions;r++) {
+                npairs += results.region_npairs[r*nbin + k];
+            }
+            if(npairs != results.npairs[k]) {
+                fprintf(stderr,"Failed (regions, autocorr = %d) in bin %d. Total npairs = %"PRIu64" Sum over the regions = %"PRIu64"\n",
+                        autocorr, k, results.npairs[k], npairs);
+                ret = EXIT_FAILURE;
+            }
+        }
+
+        /* The pairs within each region are the autocorrelation of the particles in that region */
+        for(int32_t reg=0;reg<nregions && autocorr == 1 && ret == EXIT_SUCCESS;reg++) {
+            int64_t np = 0;
+            for(int64_t i=0;i<ND1;i++) {
+                if(regions1[i] == reg) {
+                    rx[np] = X1[i];ry[np] = Y1[i];rz[np] = Z1[i];rw[np] = weights1[i];
+                    np++;
+                }
+            }
+            struct extra_options extra_region = get_extra_options(PAIR_PRODUCT);
+            extra_region.weights0.weights[0] = rw;
+            extra_region.weights1.weights[0] = rw;
+            results_countpairs region_results;
+            ret = countpairs(np, rx, ry, rz, np, rx, ry, rz, nthreads, 1, binfile, &region_results, &options, &extra_region);
+            if(ret != EXIT_SUCCESS) {
+                break;
+            }
+            for(int k=1;k<nbin;k++) {
+                const uint64_t npairs = results.region_npairs[(reg*nregions + reg)*nbin + k];
+                if(npairs != region_results.npairs[k]) {
+                    fprintf(stderr,"Failed (regions) in bin %d. npairs within region %d = %"PRIu64" Autocorrelation of the region = %"PRIu64"\n",
+                            k, reg, npairs, region_results.npairs[k]);
+                    ret = EXIT_FAILURE;
+                    break;
+                }
+            }
+            free_results(&region_results);
+        }
+        free_results(&results);
+        free_results(&expected);
+    }
+    free(regions1);free(regions2);free(rx);free(ry);free(rz);free(rw);
+    return ret;
+}
+
+/* DD, DR and RR from the single walk of countpairs_dd_dr_rr against three separate calls to countpairs */
+int test_dd_dr_rr(void)
+{
+    struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+    extra.weights0.weights[0] = weights1;
+    extra.weights1.weights[0] = weights2;
+    results_countpairs fused[3];
+    int ret = countpairs_dd_dr_rr(ND1, X1, Y1, Z1, ND2, X2, Y2, Z2, nthreads, binfile,
+                                  &fused[0], &fused[1], &fused[2], &options, &extra);
+    if(ret != EXIT_SUCCESS) {
+        return ret;
+    }
+
+    const char names[][MAXLEN] = {"fused DD", "fused DR", "fused RR"};
+    for(int c=0;c<3 && ret == EXIT_SUCCESS;c++) {
+        results_countpairs expected;
+        if(c < 2) {
+            ret = count_dd(c == 0, &expected);
+        } else {
+            struct extra_options extra_rr = get_extra_options(PAIR_PRODUCT);
+            extra_rr.weights0.weights[0] = weights2;
+            extra_rr.weights1.weights[0] = weights2;
+            ret = countpairs(ND2, X2, Y2, Z2, ND2, X2, Y2, Z2, nthreads, 1, binfile, &expected, &options, &extra_rr);
+        }
+        if(ret == EXIT_SUCCESS) {
+            ret = compare_results(names[c], &expected, &fused[c]);
+            free_results(&expected);
+        }
+    }
+    for(int c=0;c<3;c++) {
+        free_results(&fused[c]);
+    }
+    return ret;
+}
+
+/* DD (auto and cross) and xi for two bin files (logarithmic and linear bins) from one pass against one run per bin file */
+int test_multi_bins(void)
+{
+    const char *binfiles[] = {binfile, linear_binfile};
+    const int nbinfiles = sizeof(binfiles)/sizeof(binfiles[0]);
+    int ret = EXIT_SUCCESS;
+    for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        extra.weights0.weights[0] = weights1;
+        extra.weights1.weights[0] = autocorr ? weights1:weights2;
+        results_countpairs results[nbinfiles];
+        ret = countpairs_multi_bins(ND1,X1,Y1,Z1,
+                                    autocorr ? ND1:ND2, autocorr ? X1:X2, autocorr ? Y1:Y2, autocorr ? Z1:Z2,
+                                    nthreads, autocorr, nbinfiles, binfiles, results, &options, &extra);
+        if(ret != EXIT_SUCCESS) {
+            break;
+        }
+        for(int b=0;b<nbinfiles;b++) {
+            if(ret == EXIT_SUCCESS) {
+                results_countpairs expected;
+                ret = countpairs(ND1,X1,Y1,Z1,
+                                 autocorr ? ND1:ND2, autocorr ? X1:X2, autocorr ? Y1:Y2, autocorr ? Z1:Z2,
+                                 nthreads, autocorr, binfiles[b], &expected, &options, &extra);
+                if(ret == EXIT_SUCCESS) {
+                    char name[MAXLEN];
+                    my_snprintf(name, MAXLEN, "multi-bins DD (autocorr = %d, %s)", autocorr, binfiles[b]);
+                    ret = compare_results(name, &expected, &results[b]);
+                    free_results(&expected);
+                }
+            }
+            free_results(&results[b]);
+        }
+    }
+
+    if(ret == EXIT_SUCCESS) {
+        struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+        extra.weights0.weights[0] = weights1;
+        results_countpairs_xi results[nbinfiles];
+        ret = countpairs_xi_multi_bins(ND1, X1, Y1, Z1, boxsize, nthreads, nbinfiles, binfiles, results, &options, &extra);
+        if(ret == EXIT_SUCCESS) {
+            for(int b=0;b<nbinfiles && ret == EXIT_SUCCESS;b++) {
+                results_countpairs_xi expected;
+                ret = countpairs_xi(ND1, X1, Y1, Z1, boxsize, nthreads, binfiles[b], &expected, &options, &extra);
+                if(ret != EXIT_SUCCESS) {
+                    break;
+                }
+                for(int k=1;k<expected.nbin;k++) {
+                    if(expected.npairs[k] != results[b].npairs[k] ||
+                       AlmostEqualRelativeAndAbs_double(expected.xi[k], results[b].xi[k], maxdiff, maxreldiff) != EXIT_SUCCESS ||
+                       AlmostEqualRelativeAndAbs_double(expected.ravg[k], results[b].ravg[k], maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                        fprintf(stderr,"Failed (multi-bins xi, %s) in bin %d. True npairs = %"PRIu64 " xi = %e Computed npairs = %"PRIu64" xi = %e\n",
+                                binfiles[b], k, expected.npairs[k], expected.xi[k], results[b].npairs[k], results[b].xi[k]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+                free_results_xi(&expected);
+            }
+            for(int b=0;b<nbinfiles;b++) {
+                free_results_xi(&results[b]);
+            }
+        }
+    }
+    return ret;
+}
+
+/* DD (auto and cross, periodic and not) and wp with every cell padded and aligned (BINNING_LAY_PADDED) against the
+   packed cells, for every instruction set -> the kernels must never read the sentinels past the end of a cell */
+int test_padded_cells(void)
+{
+    int ret = EXIT_SUCCESS;
+    const int save_isa = options.instruction_set;
+    const int save_periodic = options.periodic;
+    for(int iset=0;iset<ntest_isa && ret == EXIT_SUCCESS;iset++) {
+        options.instruction_set = test_isa[iset];
+        for(int periodic=0;periodic<2 && ret == EXIT_SUCCESS;periodic++) {
+            for(int autocorr=0;autocorr<2 && ret == EXIT_SUCCESS;autocorr++) {
+                options.periodic = periodic;
+                results_countpairs expected, results;
+                ret = count_dd(autocorr, &expected);
+                if(ret != EXIT_SUCCESS) {
+                    break;
+                }
+                set_cell_layout(&options, BINNING_LAY_PADDED);
+                ret = count_dd(autocorr, &results);
+                set_cell_layout(&options, BINNING_LAY_PACKED);
+                if(ret == EXIT_SUCCESS) {
+                    char name[MAXLEN];
+                    my_snprintf(name, MAXLEN, "padded DD (%s, periodic = %d, autocorr = %d)", test_isa_names[iset], periodic, autocorr);
+                    ret = compare_results(name, &expected, &results);
+                    free_results(&results);
+                }
+                free_results(&expected);
+            }
+        }
+        options.periodic = save_periodic;
+
+        if(ret == EXIT_SUCCESS) {
+            const double pimax = 20.0;
+            struct extra_options extra = get_extra_options(PAIR_PRODUCT);
+            extra.weights0.weights[0] = weights1;
+            results_countpairs_wp expected, results;
+            ret = countpairs_wp(ND1, X1, Y1, Z1, boxsize, nthreads, binfile, pimax, &expected, &options, &extra);
+            if(ret != EXIT_SUCCESS) {
+                break;
+            }
+            set_cell_layout(&options, BINNING_LAY_PADDED);
+            ret = countpairs_wp(ND1, X1, Y1, Z1, boxsize, nthreads, binfile, pimax, &results, &options, &extra);
+            set_cell_layout(&options, BINNING_LAY_PACKED);
+            if(ret == EXIT_SUCCESS) {
+                for(int k=1;k<expected.nbin;k++) {
+                    if(expected.npairs[k] != results.npairs[k] ||
+                       AlmostEqualRelativeAndAbs_double(expected.rpavg[k], results.rpavg[k], maxdiff, maxreldiff) != EXIT_SUCCESS ||
+                       AlmostEqualRelativeAndAbs_double(expected.weightavg[k], results.weightavg[k], maxdiff, maxreldiff) != EXIT_SUCCESS) {
+                        fprintf(stderr,"Failed (padded wp, %s) in bin %d. True npairs = %"PRIu64 " rpavg = %e Computed npairs = %"PRIu64" rpavg = %e\n",
+                                test_isa_names[iset], k, expected.npairs[k], expected.rpavg[k], results.npairs[k], results.rpavg[k]);
+                        ret = EXIT_FAILURE;
+                        break;
+                    }
+                }
+                free_results_wp(&results);
+            }
+            free_results_wp(&expected);
+        }
+    }
+    options.instruction_set = save_isa;
+    return ret;
+}
+
+/* The bin of r2 from the backward scan over the edges, as in the kernels before the bin lookup */
+static int scan_bin(const double r2, const double *rupp_sqr, const int nbin)
+{
+    for(int kbin=nbin-1;kbin>=1;kbin--) {
+        if(r2 >= rupp_sqr[kbin-1]) {
+            return kbin;
+        }
+    }
+    return 0;
+}
+
+/* The bins of the SIMD lookup (one vector of n <= nvec values, the lanes past n masked out) against expected */
+static int compare_bins(const char *name, const char *isa_name, const int nvec, const int n, const double *r2,
+                        const double *bins, const int *expected)
+{
+    for(int jj=0;jj<nvec;jj++) {
+        const int kbin = jj < n ? expected[jj]:0;
+        if((int) bins[jj] != kbin) {
+            fprintf(stderr,"Failed (%s bin lookup, %s) for r2 = %.17g. True bin = %d Computed bin = %g\n",
+                    name, isa_name, jj < n ? r2[jj]:0.0, kbin, bins[jj]);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* get_bin_index and the SIMD bin lookups (with the bins counted into npairs) against the backward scan, for every
+   edge, the doubles on either side of it and random values up to beyond the last edge */
+static int check_bin_lookup(const char *name, const int nbin, const double *rupp, const bin_spacing_t spacing)
+{
+    bin_lookup_double lookup;
+    setup_bin_lookup_double(nbin, rupp, &lookup);
+    if(lookup.spacing != spacing) {
+        fprintf(stderr,"Failed (%s bin lookup). True spacing = %d Detected spacing = %d\n", name, spacing, lookup.spacing);
+        return EXIT_FAILURE;
+    }
+    double rupp_sqr[nbin];
+    for(int k=0;k<nbin;k++) {
+        rupp_sqr[k] = rupp[k]*rupp[k];
+    }
+
+    /* padded by a vector of zeros -> the last vector is loaded whole */
+    const int nedge_values = 3*nbin, nrandom = 1000;
+    const int nvalues = nedge_values + nrandom + 1;
+    double r2[nvalues + 16];
+    int expected[nvalues];
+    uint64_t expected_npairs[nbin];
+    for(int k=0;k<nbin;k++) {
+        r2[3*k] = rupp_sqr[k];
+        r2[3*k + 1] = nextafter(rupp_sqr[k], 0.0);
+        r2[3*k + 2] = nextafter(rupp_sqr[k], INFINITY);
+        expected_npairs[k] = 0;
+    }
+    for(int i=0;i<nrandom;i++) {
+        r2[nedge_values + i] = 1.2*rupp_sqr[nbin-1]*random_uniform();
+    }
+    for(int i=nvalues-1;i<nvalues + 16;i++) {
+        r2[i] = 0.0;
+    }
+    for(int i=0;i<nvalues;i++) {
+        expected[i] = scan_bin(r2[i], rupp_sqr, nbin);
+        expected_npairs[expected[i]]++;
+    }
+
+    for(int i=0;i<nvalues;i++) {
+        const int kbin = get_bin_index_double(r2[i], rupp_sqr, &lookup);
+        if(kbin != expected[i]) {
+            fprintf(stderr,"Failed (%s bin lookup, scalar) for r2 = %.17g. True bin = %d Computed bin = %d\n",
+                    name, r2[i], expected[i], kbin);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const int highest_isa = instrset_detect();
+    (void) highest_isa;
+    uint64_t npairs[nbin];
+    double bins[16];
+#ifdef __AVX512F__
+    if(highest_isa >= 9) {
+        memset(npairs, 0, sizeof(npairs));
+        for(int i=0;i<nvalues;i+=AVX512_NVEC) {
+            const int n = nvalues - i < AVX512_NVEC ? nvalues - i:AVX512_NVEC;
+            AVX512_STORE_FLOATS_TO_MEMORY(bins, avx512_bin_lookup_double(avx512_mask_first_n(n), AVX512_LOAD_FLOATS_UNALIGNED(&r2[i]),
+                                                                         rupp_sqr, &lookup, npairs));
+            if(compare_bins(name, "AVX512F", AVX512_NVEC, n, &r2[i], bins, &expected[i]) != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        if(memcmp(npairs, expected_npairs, sizeof(npairs)) != 0) {
+            fprintf(stderr,"Failed (%s bin lookup, AVX512F). The counts of the bins differ\n", name);
+            return EXIT_FAILURE;
+        }
+    }
+#endif
+#ifdef __AVX__
+    if(highest_isa >= 7) {
+        memset(npairs, 0, sizeof(npairs));
+        for(int i=0;i<nvalues;i+=AVX_NVEC) {
+            const int n = nvalues - i < AVX_NVEC ? nvalues - i:AVX_NVEC;
+            AVX_STORE_FLOATS_TO_MEMORY(bins, avx_bin_lookup_double(avx_mask_first_n(n), AVX_LOAD_FLOATS_UNALIGNED(&r2[i]),
+                                                                   rupp_sqr, &lookup, npairs));
+            if(compare_bins(name, "AVX", AVX_NVEC, n, &r2[i], bins, &expected[i]) != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        if(memcmp(npairs, expected_npairs, sizeof(npairs)) != 0) {
+            fprintf(stderr,"Failed (%s bin lookup, AVX). The counts of the bins differ\n", name);
+            return EXIT_FAILURE;
+        }
+    }
+#endif
+#ifdef __SSE4_2__
+    if(highest_isa >= 6) {
+        memset(npairs, 0, sizeof(npairs));
+        for(int i=0;i<nvalues;i+=SSE_NVEC) {
+            const int n = nvalues - i < SSE_NVEC ? nvalues - i:SSE_NVEC;
+            SSE_STORE_FLOATS_TO_MEMORY(bins, sse_bin_lookup_double(sse_mask_first_n(n), SSE_LOAD_FLOATS_UNALIGNED(&r2[i]),
+                                                                   rupp_sqr, &lookup, npairs));
+            if(compare_bins(name, "SSE4.2", SSE_NVEC, n, &r2[i], bins, &expected[i]) != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        if(memcmp(npairs, expected_npairs, sizeof(npairs)) != 0) {
+            fprintf(stderr,"Failed (%s bin lookup, SSE4.2). The counts of the bins differ\n", name);
+            return EXIT_FAILURE;
+        }
+    }
+#endif
+    return EXIT_SUCCESS;
+}
+
+/* The bin lookup for bins uniform in r, in log(r) and in r^2 against the backward scan over the edges */
+int test_bin_lookup(void)
+{
+    const int nbin = 21;
+    const double rmin = 0.1, rmax = 25.0;
+    double rupp[nbin];
+    for(int k=0;k<nbin;k++) {
+        rupp[k] = rmin + k*(rmax - rmin)/(nbin - 1);
+    }
+    int ret = check_bin_lookup("linear", nbin, rupp, BIN_SPACING_LINEAR);
+    if(ret == EXIT_SUCCESS) {
+        for(int k=0;k<nbin;k++) {
+            rupp[k] = rmin*pow(rmax/rmin, k/(double) (nbin - 1));
+        }
+        ret = check_bin_lookup("log", nbin, rupp, BIN_SPACING_LOG);
+    }
+    if(ret == EXIT_SUCCESS) {
+        for(int k=0;k<nbin;k++) {
+            rupp[k] = sqrt(rmin*rmin + k*(rmax*rmax - rmin*rmin)/(nbin - 1));
+        }
+        ret = check_bin_lookup("r^2", nbin, rupp, BIN_SPACING_LINEAR_SQR);
+    }
+    return ret;
+}
+
+void generate_catalog(void)
+{
+    ND1 = NPART;
+    X1 = my_malloc(sizeof(*X1), ND1);
+    Y1 = my_malloc(sizeof(*Y1), ND1);
+    Z1 = my_malloc(sizeof(*Z1), ND1);
+    weights1 = my_malloc(sizeof(*weights1), ND1);
+    bitmasks1 = my_malloc(sizeof(*bitmasks1), ND1);
+    assert(X1 != NULL && Y1 != NULL && Z1 != NULL && weights1 != NULL && bitmasks1 != NULL && "Allocated the test catalog");
+    for(int64_t i=0;i<ND1;i++) {
+        if(i % 2) {
+            // half of the particles in a few clumps -> pairs in the small bins
+            const int64_t c = i % 7;
+            X1[i] = fmod(10.0 + 11.0*c + 3.0*(random_uniform() - 0.5) + boxsize, boxsize);
+            Y1[i] = fmod(20.0 + 7.0*c + 3.0*(random_uniform() - 0.5) + boxsize, boxsize);
+            Z1[i] = fmod(30.0 + 5.0*c + 3.0*(random_uniform() - 0.5) + boxsize, boxsize);
+        } else {
+            X1[i] = boxsize*random_uniform();
+            Y1[i] = boxsize*random_uniform();
+            Z1[i] = boxsize*random_uniform();
+        }
+        weights1[i] = 0.5 + random_uniform();
+        // about one in ten particles is never selected -> pairs with an empty intersection
+        bitmasks1[i] = (i % 10 == 0) ? 0:(int64_t) (random_bits() | random_bits());
+    }
+
+    ND2 = NRAND;
+    X2 = my_malloc(sizeof(*X2), ND2);
+    Y2 = my_malloc(sizeof(*Y2), ND2);
+    Z2 = my_malloc(sizeof(*Z2), ND2);
+    weights2 = my_malloc(sizeof(*weights2), ND2);
+    assert(X2 != NULL && Y2 != NULL && Z2 != NULL && weights2 != NULL && "Allocated the randoms");
+    for(int64_t i=0;i<ND2;i++) {
+        X2[i] = boxsize*random_uniform();
+        Y2[i] = boxsize*random_uniform();
+        Z2[i] = boxsize*random_uniform();
+        weights2[i] = 0.5 + random_uniform();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    struct timeval tstart,t0,t1;
+    options = get_config_options();
+    options.need_avg_sep=1;
+    options.verbose=0;
+    options.periodic=1;
+    options.boxsize=boxsize;
+    options.float_type=sizeof(double);
+
+    gettimeofday(&tstart,NULL);
+    generate_catalog();
+    reset_bin_refine_factors(&options);
+
+    int failed=0;
+    int status;
+
+    const char alltests_names[][MAXLEN] = {"DD PIP weights (brute force)",
+                                           "DD separation table weights (brute force)",
+                                           "DD and xi from prepared catalogs",
+                                           "DD from the kd-tree",
+                                           "DD and wp in z-slabs",
+                                           "DD from updated prepared catalogs",
+                                           "DD with region labels",
+                                           "DD, DR and RR in one walk",
+                                           "DD and xi for several bin files in one pass",
+                                           "DD and wp with padded cells",
+                                           "Bin lookup against the backward scan"};
+    int (*allfunctions[]) (void) = {test_pip_weights,
+                                    test_separation_table_weights,
+                                    test_prepared,
+                                    test_kdtree,
+                                    test_slabs,
+                                    test_prepared_update,
+                                    test_regions,
+                                    test_dd_dr_rr,
+                                    test_multi_bins,
+                                    test_padded_cells,
+                                    test_bin_lookup};
+    const int ntests = sizeof(alltests_names)/(sizeof(char)*MAXLEN);
+    const int numfunctions = sizeof(allfunctions)/sizeof(allfunctions[0]);
+    assert(ntests == numfunctions && "Every test has a name");
+
+    int total_tests=0;
+    for(int i=0;i<ntests;i++) {
+        // nothing was passed at the command-line -> run all tests
+        if(argc > 1) {
+            int requested = 0;
+            for(int a=1;a<argc;a++) {
+                if(atoi(argv[a]) == i) {
+                    requested = 1;
+                }
+            }
+            if(requested == 0) continue;
+        }
+        const char *testname = alltests_names[i];
+        gettimeofday(&t0,NULL);
+        status = (*allfunctions[i])();
+        gettimeofday(&t1,NULL);
+        double pair_time = ADD_DIFF_TIME(t0,t1);
+        total_tests++;
+        if(status==EXIT_SUCCESS) {
+            fprintf(stderr,ANSI_COLOR_GREEN "PASSED: " ANSI_COLOR_MAGENTA "%s" ANSI_COLOR_GREEN ". Time taken = %8.2lf seconds " ANSI_COLOR_RESET "\n", testname,pair_time);
+        } else {
+            fprintf(stderr,ANSI_COLOR_RED "FAILED: " ANSI_COLOR_MAGENTA "%s" ANSI_COLOR_RED ". Time taken = %8.2lf seconds " ANSI_COLOR_RESET "\n", testname,pair_time);
+            failed++;
+        }
+    }
+
+    gettimeofday(&t1,NULL);
+    double total_time = ADD_DIFF_TIME(tstart,t1);
+    if(failed > 0) {
+        fprintf(stderr,ANSI_COLOR_RED "FAILED %d out of %d tests. Total time = %8.2lf seconds " ANSI_COLOR_RESET "\n", failed, total_tests, total_time);
+    } else {
+        fprintf(stderr,ANSI_COLOR_GREEN "PASSED: ALL %d tests. Total time = %8.2lf seconds " ANSI_COLOR_RESET "\n", total_tests, total_time);
+    }
+
+    free(X1);free(Y1);free(Z1);free(weights1);free(bitmasks1);
+    free(X2);free(Y2);free(Z2);free(weights2);
+    return failed;
+}
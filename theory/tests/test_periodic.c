@@ -35,6 +35,8 @@ int test_periodic_DDrppi(const char *correct_outputfile);
 int test_wp(const char *correct_outputfile);
 int test_vpf(const char *correct_outputfile);
 int test_xi(const char *correct_outputfile);
+int test_periodic_DD_mixed_precision(const char *correct_outputfile);
+int test_wp_mixed_precision(const char *correct_outputfile);
 
 void read_data_and_set_globals(const char *firstfilename, const char *firstformat,
                                const char *secondfilename, const char *secondformat);
@@ -61,6 +63,11 @@ struct config_options options;
 const double maxdiff = 1e-9;
 const double maxreldiff = 1e-6;
 
+/* Float positions with the averages summed in double (mixed_precision) against the double results. The
+   pair counts may differ by the few pairs within the float rounding of a bin edge */
+const double mixed_maxdiff_npairs = 4.0;
+const double mixed_maxreldiff = 1e-5;
+
 //end global variables
 
 int test_periodic_DD(const char *correct_outputfile)
@@ -434,6 +441,180 @@ int test_xi(const char *correct_outputfile)
     return ret;
 }
 
+/* Float copy of x[0..N-1] for the mixed precision tests */
+static float *float_copy(const int N, const double *x)
+{
+    float *f = malloc(sizeof(*f)*N);
+    if(f == NULL) {
+        return NULL;
+    }
+    for(int i=0;i<N;i++) {
+        f[i] = (float) x[i];
+    }
+    return f;
+}
+
+int test_periodic_DD_mixed_precision(const char *correct_outputfile)
+{
+    int autocorr = (X1==X2) ? 1:0;
+    float *f1[4] = {float_copy(ND1, X1), float_copy(ND1, Y1), float_copy(ND1, Z1), float_copy(ND1, weights1)};
+    float *f2[4] = {f1[0], f1[1], f1[2], f1[3]};
+    if(autocorr == 0) {
+        f2[0] = float_copy(ND2, X2);f2[1] = float_copy(ND2, Y2);f2[2] = float_copy(ND2, Z2);f2[3] = float_copy(ND2, weights2);
+    }
+
+    weight_method_t weight_method = PAIR_PRODUCT;
+    struct extra_options extra = get_extra_options(weight_method);
+    extra.weights0.weights[0] = f1[3];
+    extra.weights1.weights[0] = f2[3];
+
+    options.float_type = sizeof(float);
+    options.mixed_precision = 1;
+    results_countpairs results;
+    int status = countpairs(ND1,f1[0],f1[1],f1[2],
+                            ND2,f2[0],f2[1],f2[2],
+                            nthreads,
+                            autocorr,
+                            binfile,
+                            &results,
+                            &options,
+                            &extra);
+    options.float_type = sizeof(double);
+    options.mixed_precision = 0;
+    for(int k=0;k<4;k++) {
+        if(autocorr == 0) {
+            free(f2[k]);
+        }
+        free(f1[k]);
+    }
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+
+    int ret = EXIT_FAILURE;
+    double rlow=results.rupp[0];
+    FILE *fp = my_fopen(correct_outputfile,"r");
+    for(int i=1;i<results.nbin;i++) {
+        uint64_t npairs;
+        double rpavg, weightavg;
+        ret = EXIT_FAILURE;
+        int nitems = fscanf(fp,"%"SCNu64" %lf %*f %*f %lf", &npairs, &rpavg, &weightavg);
+        if(nitems != 3) {
+            ret = EXIT_FAILURE;//not required but showing intent
+            break;
+        }
+        int npairs_equal = AlmostEqualRelativeAndAbs_double((double) npairs, (double) results.npairs[i], mixed_maxdiff_npairs, mixed_maxreldiff);
+        int floats_equal = AlmostEqualRelativeAndAbs_double(rpavg, results.rpavg[i], maxdiff, mixed_maxreldiff);
+        int weights_equal = AlmostEqualRelativeAndAbs_double(weightavg, results.weightavg[i], maxdiff, mixed_maxreldiff);
+
+        if(npairs_equal == EXIT_SUCCESS && floats_equal == EXIT_SUCCESS && weights_equal == EXIT_SUCCESS) {
+            ret = EXIT_SUCCESS;
+        } else {
+            ret = EXIT_FAILURE;//not required but showing intent
+            fprintf(stderr,"Failed. True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n", npairs, results.npairs[i]);
+            fprintf(stderr,"Failed. True rpavg = %e Computed rpavg = %e. floats_equal = %d\n", rpavg, results.rpavg[i], floats_equal);
+            fprintf(stderr,"Failed. True weightavg = %e Computed weightavg = %e. weights_equal = %d\n", weightavg, results.weightavg[i], weights_equal);
+            break;
+        }
+    }
+    fclose(fp);
+
+    if(ret != EXIT_SUCCESS) {
+        fp=my_fopen(tmpoutputfile,"w");
+        if(fp == NULL) {
+            free_results(&results);
+            return EXIT_FAILURE;
+        }
+        for(int i=1;i<results.nbin;i++) {
+            fprintf(fp,"%10"PRIu64" %20.8lf %20.8lf %20.8lf %20.8lf \n",results.npairs[i],results.rpavg[i],rlow,results.rupp[i],results.weightavg[i]);
+            rlow = results.rupp[i];
+        }
+        fclose(fp);
+    }
+
+    free_results(&results);
+    return ret;
+}
+
+int test_wp_mixed_precision(const char *correct_outputfile)
+{
+    float *f1[4] = {float_copy(ND1, X1), float_copy(ND1, Y1), float_copy(ND1, Z1), float_copy(ND1, weights1)};
+
+    weight_method_t weight_method = PAIR_PRODUCT;
+    struct extra_options extra = get_extra_options(weight_method);
+    extra.weights0.weights[0] = f1[3];
+
+    options.float_type = sizeof(float);
+    options.mixed_precision = 1;
+    results_countpairs_wp results;
+    int status = countpairs_wp(ND1,f1[0],f1[1],f1[2],
+                               boxsize,
+                               nthreads,
+                               binfile,
+                               pimax,
+                               &results,
+                               &options,
+                               &extra);
+    options.float_type = sizeof(double);
+    options.mixed_precision = 0;
+    for(int k=0;k<4;k++) {
+        free(f1[k]);
+    }
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+
+    int ret = EXIT_FAILURE;
+    double rlow=results.rupp[0];
+    FILE *fp=my_fopen(correct_outputfile,"r");
+    for(int i=1;i<results.nbin;i++) {
+        uint64_t npairs;
+        double rpavg,wp,weightavg;
+        ret = EXIT_FAILURE;
+        int nitems = fscanf(fp,"%lf %lf %*f %*f %"SCNu64" %lf%*[^\n]", &wp, &rpavg, &npairs, &weightavg);//discard rlow and rupp
+        if(nitems != 4) {
+            ret = EXIT_FAILURE;//not required but showing intent
+            break;
+        }
+        int npairs_equal = AlmostEqualRelativeAndAbs_double((double) npairs, (double) results.npairs[i], mixed_maxdiff_npairs, mixed_maxreldiff);
+        int rpavg_equal = AlmostEqualRelativeAndAbs_double(rpavg, results.rpavg[i], maxdiff, mixed_maxreldiff);
+        int weightavg_equal = AlmostEqualRelativeAndAbs_double(weightavg, results.weightavg[i], maxdiff, mixed_maxreldiff);
+        int wp_equal = AlmostEqualRelativeAndAbs_double(wp, results.wp[i], maxdiff, mixed_maxreldiff);
+
+        if(npairs_equal == EXIT_SUCCESS && rpavg_equal == EXIT_SUCCESS && wp_equal == EXIT_SUCCESS && weightavg_equal == EXIT_SUCCESS) {
+            ret = EXIT_SUCCESS;
+        } else {
+            ret = EXIT_FAILURE;//not required but showing intent
+            fprintf(stderr,"Failed. True npairs = %"PRIu64 " Computed results npairs = %"PRIu64"\n", npairs, results.npairs[i]);
+            fprintf(stderr,"Failed. True wp = %e Computed results wp = %e\n", wp, results.wp[i]);
+            fprintf(stderr,"Failed. True rpavg = %e Computed rpavg = %e.\n",
+                    rpavg, results.rpavg[i]);
+            fprintf(stderr,"Failed. True weightavg = %e Computed weightavg = %e.\n",
+                    weightavg, results.weightavg[i]);
+            fprintf(stderr," wp_equal = %d rpavg_equal = %d weightavg_equal = %d\n", wp_equal, rpavg_equal, weightavg_equal);
+            break;
+        }
+    }
+    fclose(fp);
+
+    /* Test failed. Output the results into a temporary file */
+    if(ret != EXIT_SUCCESS) {
+        fp=my_fopen(tmpoutputfile,"w");
+        if(fp == NULL) {
+            free_results_wp(&results);
+            return EXIT_FAILURE;
+        }
+        for(int i=1;i<results.nbin;++i) {
+            fprintf(fp,"%e\t%e\t%e\t%e\t%12"PRIu64"\t%e \n",results.wp[i],results.rpavg[i],rlow,results.rupp[i],results.npairs[i], results.weightavg[i]);
+            rlow=results.rupp[i];
+        }
+        fclose(fp);
+    }
+
+    free_results_wp(&results);
+    return ret;
+}
+
 void read_data_and_set_globals(const char *firstfilename, const char *firstformat,
                                const char *secondfilename, const char *secondformat)
 {
@@ -527,9 +708,11 @@ int main(int argc, char **argv)
                                            "Mr19 xi periodic)",
                                            "CMASS DDrppi DD (periodic)",
                                            "CMASS DDrppi DR (periodic)",
-                                           "CMASS DDrppi RR (periodic)"};
+                                           "CMASS DDrppi RR (periodic)",
+                                           "Mr19 DD (periodic, mixed precision)",
+                                           "Mr19 wp (periodic, mixed precision)"};
     const int ntests = sizeof(alltests_names)/(sizeof(char)*MAXLEN);
-    const int function_pointer_index[] = {1,0,2,3,4,1,1,1};//0->DD, 1->DDrppi,2->wp, 3->vpf, 4->xi
+    const int function_pointer_index[] = {1,0,2,3,4,1,1,1,5,6};//0->DD, 1->DDrppi,2->wp, 3->vpf, 4->xi, 5->DD (mixed), 6->wp (mixed)
 
     const char correct_outputfiles[][MAXLEN] = {"Mr19_DDrppi_periodic",
                                                 "Mr19_DD_periodic",
@@ -538,7 +721,9 @@ int main(int argc, char **argv)
                                                 "Mr19_xi",
                                                 "cmass_DD_periodic",
                                                 "cmass_DR_periodic",
-                                                "cmass_RR_periodic"};
+                                                "cmass_RR_periodic",
+                                                "Mr19_DD_periodic",
+                                                "Mr19_wp"};
     const char firstfilename[][MAXLEN] = {"../tests/data/gals_Mr19.ff",
                                           "../tests/data/gals_Mr19.ff",
                                           "../tests/data/gals_Mr19.ff",
@@ -546,8 +731,10 @@ int main(int argc, char **argv)
                                           "../tests/data/gals_Mr19.ff",
                                           "../tests/data/cmassmock_Zspace.ff",
                                           "../tests/data/cmassmock_Zspace.ff",
-                                          "../tests/data/random_Zspace.ff"};
-    const char firstfiletype[][MAXLEN] = {"f","f","f","f","f","f","f","f"};
+                                          "../tests/data/random_Zspace.ff",
+                                          "../tests/data/gals_Mr19.ff",
+                                          "../tests/data/gals_Mr19.ff"};
+    const char firstfiletype[][MAXLEN] = {"f","f","f","f","f","f","f","f","f","f"};
     const char secondfilename[][MAXLEN] = {"../tests/data/gals_Mr19.ff",
                                            "../tests/data/gals_Mr19.ff",
                                            "../tests/data/gals_Mr19.ff",
@@ -555,16 +742,20 @@ int main(int argc, char **argv)
                                            "../tests/data/gals_Mr19.ff",
                                            "../tests/data/cmassmock_Zspace.ff",
                                            "../tests/data/random_Zspace.ff",
-                                           "../tests/data/random_Zspace.ff"};
-    const char secondfiletype[][MAXLEN] = {"f","f","f","f","f","f","f","f"};
-    const double allpimax[]             = {40.0,40.0,40.0,40.0,40.0,80.0,80.0,80.0};
+                                           "../tests/data/random_Zspace.ff",
+                                           "../tests/data/gals_Mr19.ff",
+                                           "../tests/data/gals_Mr19.ff"};
+    const char secondfiletype[][MAXLEN] = {"f","f","f","f","f","f","f","f","f","f"};
+    const double allpimax[]             = {40.0,40.0,40.0,40.0,40.0,80.0,80.0,80.0,40.0,40.0};
 
     int (*allfunctions[]) (const char *) = {test_periodic_DD,
                                             test_periodic_DDrppi,
                                             test_wp,
                                             test_vpf,
-                                            test_xi};
-    const int numfunctions=5;//5 functions total
+                                            test_xi,
+                                            test_periodic_DD_mixed_precision,
+                                            test_wp_mixed_precision};
+    const int numfunctions=7;//7 functions total
 
     int total_tests=0,skipped=0;
 
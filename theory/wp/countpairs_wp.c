@@ -67,3 +67,130 @@ int countpairs_wp(const int64_t ND, void * restrict X, void * restrict Y, void *
                                   extra);
     }
 }
+
+
+int countpairs_wp_multi_bins(const int64_t ND, void * restrict X, void * restrict Y, void * restrict Z,
+                             const double boxsize,
+                             const int numthreads,
+                             const int nbinfiles, const char **binfiles,
+                             const double pimax,
+                             results_countpairs_wp *results,
+                             struct config_options *options,
+                             struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+    
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1 ) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+      return countpairs_wp_multi_bins_float(ND, (float * restrict) X, (float * restrict) Y, (float * restrict) Z,
+                                            boxsize,
+                                            numthreads,
+                                            nbinfiles, binfiles,
+                                            pimax,
+                                            results,
+                                            options,
+                                            extra);
+    } else {
+      return countpairs_wp_multi_bins_double(ND, (double * restrict) X, (double * restrict) Y, (double * restrict) Z,
+                                             boxsize,
+                                             numthreads,
+                                             nbinfiles, binfiles,
+                                             pimax,
+                                             results,
+                                             options,
+                                             extra);
+    }
+}
+
+
+int countpairs_wp_prepared(prepared_catalog *catalog,
+                           const double boxsize,
+                           const int numthreads,
+                           const char *binfile,
+                           const double pimax,
+                           results_countpairs_wp *results,
+                           struct config_options *options,
+                           struct extra_options *extra)
+{
+    if(catalog == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1 ) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    /* The precision is set by the catalog */
+    options->float_type = catalog->float_type;
+    if(options->float_type == sizeof(float)) {
+      return countpairs_wp_prepared_float(catalog,
+                                          boxsize,
+                                          numthreads,
+                                          binfile,
+                                          pimax,
+                                          results,
+                                          options,
+                                          extra);
+    } else {
+      return countpairs_wp_prepared_double(catalog,
+                                           boxsize,
+                                           numthreads,
+                                           binfile,
+                                           pimax,
+                                           results,
+                                           options,
+                                           extra);
+    }
+}
+
+
+int countpairs_wp_slabs(particle_source *source,
+                        const double boxsize,
+                        const int numthreads,
+                        const char *binfile,
+                        const double pimax,
+                        results_countpairs_wp *results,
+                        struct config_options *options,
+                        struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1 ) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+      return countpairs_wp_slabs_float(source,
+                                       boxsize,
+                                       numthreads,
+                                       binfile,
+                                       pimax,
+                                       results,
+                                       options,
+                                       extra);
+    } else {
+      return countpairs_wp_slabs_double(source,
+                                        boxsize,
+                                        numthreads,
+                                        binfile,
+                                        pimax,
+                                        results,
+                                        options,
+                                        extra);
+    }
+}
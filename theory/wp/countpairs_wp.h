@@ -14,6 +14,8 @@ extern "C" {
 #endif
 
 #include "defs.h"
+#include "prepared_catalog.h"//for prepared_catalog
+#include "particle_source.h"//for particle_source
 #include <stdint.h>
     
     //define the results structure
@@ -36,6 +38,40 @@ extern "C" {
                              struct config_options *options,
                              struct extra_options *extra) __attribute__((warn_unused_result));
 
+    /* Same as countpairs_wp but with a catalog that has already been gridded with prepare_catalog.
+       The catalog must have been prepared in periodic mode, with the same boxsize. */
+    extern int countpairs_wp_prepared(prepared_catalog *catalog,
+                                      const double boxsize,
+                                      const int numthreads,
+                                      const char *binfile,
+                                      const double pimax,
+                                      results_countpairs_wp *result,
+                                      struct config_options *options,
+                                      struct extra_options *extra) __attribute__((warn_unused_result));
+
+    /* Same as countpairs_wp but the particles are read from the source and counted one z-slab at a
+       time so that the memory footprint stays within options->memory_budget (see countpairs_slabs in DD) */
+    extern int countpairs_wp_slabs(particle_source *source,
+                                   const double boxsize,
+                                   const int numthreads,
+                                   const char *binfile,
+                                   const double pimax,
+                                   results_countpairs_wp *result,
+                                   struct config_options *options,
+                                   struct extra_options *extra) __attribute__((warn_unused_result));
+
+    /* wp for several bin specifications (one bin file each) from one pass over the pairs (see bin_specs.h).
+       results is an array with one entry for each of the nbinfiles bin files, and each entry is the same as from
+       countpairs_wp with that bin file. The memory budget is not supported */
+    extern int countpairs_wp_multi_bins(const int64_t ND1, void * restrict X1, void * restrict Y1, void * restrict Z1,
+                                        const double boxsize,
+                                        const int numthreads,
+                                        const int nbinfiles, const char **binfiles,
+                                        const double pimax,
+                                        results_countpairs_wp *results,
+                                        struct config_options *options,
+                                        struct extra_options *extra) __attribute__((warn_unused_result));
+
     extern void free_results_wp(results_countpairs_wp *results);
 
 #ifdef __cplusplus
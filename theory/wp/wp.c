@@ -38,6 +38,9 @@
 #include "utils.h" //general utilities
 
 void Printhelp(void);
+int wp_streamed(const double boxsize, const char *file, const char *fileformat, const char *weights_file, const char *weights_fileformat,
+                const weight_method_t weight_method, const int num_weights,
+                const int nthreads, const char *binfile, const DOUBLE pimax, struct timeval t_start);
 
 int main(int argc, char *argv[])
 {
@@ -157,6 +160,11 @@ int main(int argc, char *argv[])
     }
     fprintf(stderr,"\t\t -------------------------------------\n");
 
+    /* With a memory budget (MEMORY_BUDGET in theory.options), the particles are streamed from the files */
+    if(get_config_options().memory_budget > 0) {
+        return wp_streamed(boxsize, file, fileformat, weights_file, weights_fileformat,
+                           weight_method, num_weights, nthreads, binfile, pimax, t_start);
+    }
 
     gettimeofday(&t0,NULL);
     /*---Read-data1-file----------------------------------*/
@@ -245,6 +253,52 @@ int main(int argc, char *argv[])
     return EXIT_SUCCESS;
 }
 
+/*---Count-pairs-one-z-slab-at-a-time-----------------*/
+int wp_streamed(const double boxsize, const char *file, const char *fileformat, const char *weights_file, const char *weights_fileformat,
+                const weight_method_t weight_method, const int num_weights,
+                const int nthreads, const char *binfile, const DOUBLE pimax, struct timeval t_start)
+{
+    struct timeval t_end,t0,t1;
+    particle_source source;
+    if(open_particle_source(&source, file, fileformat, weights_file, weights_fileformat,
+                            weights_file != NULL ? num_weights:0, sizeof(DOUBLE)) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    gettimeofday(&t0,NULL);
+    struct config_options options = get_config_options();
+    options.verbose=0;
+    struct extra_options extra = get_extra_options(weight_method);
+    results_countpairs_wp results;
+    int status = countpairs_wp_slabs(&source,
+                                     boxsize,
+                                     nthreads,
+                                     binfile,
+                                     pimax,
+                                     &results,
+                                     &options,
+                                     &extra);
+    const int64_t ND1 = source.np;
+    close_particle_source(&source);
+    if(status != EXIT_SUCCESS) {
+        return status;
+    }
+    gettimeofday(&t1,NULL);
+    double pair_time = ADD_DIFF_TIME(t0,t1);
+
+    double rlow=results.rupp[0];
+    for(int i=1;i<results.nbin;++i) {
+        fprintf(stdout,"%e\t%e\t%e\t%12"PRIu64"\t%e\t%e\n", rlow, results.rupp[i], results.rpavg[i], results.npairs[i], results.wp[i], results.weightavg[i]);
+        rlow=results.rupp[i];
+    }
+
+    free_results_wp(&results);
+    gettimeofday(&t_end,NULL);
+    fprintf(stderr,"wp> Done -  ND1=%12"PRId64". Time taken = %6.2lf seconds (streamed the particles in z-slabs). pair-counting time = %6.2lf sec\n",
+            ND1,ADD_DIFF_TIME(t_start,t_end),pair_time);
+    return EXIT_SUCCESS;
+}
+
 /*---Print-help-information---------------------------*/
 void Printhelp(void)
 {
@@ -64,3 +64,80 @@ int countpairs_xi(const int64_t ND, void * restrict X, void * restrict Y, void *
                                     extra);
     }
 }
+
+
+int countpairs_xi_multi_bins(const int64_t ND, void * restrict X, void * restrict Y, void * restrict Z,
+                             const double boxsize,
+                             const int numthreads,
+                             const int nbinfiles, const char **binfiles,
+                             results_countpairs_xi *results,
+                             struct config_options *options,
+                             struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+    
+    if(options->float_type == sizeof(float)) {
+        return countpairs_xi_multi_bins_float(ND, (float * restrict) X, (float * restrict) Y, (float * restrict) Z,
+                                              boxsize,
+                                              numthreads,
+                                              nbinfiles, binfiles,
+                                              results,
+                                              options,
+                                              extra);
+    } else {
+        return countpairs_xi_multi_bins_double(ND, (double * restrict) X, (double * restrict) Y, (double * restrict) Z,
+                                               boxsize,
+                                               numthreads,
+                                               nbinfiles, binfiles,
+                                               results,
+                                               options,
+                                               extra);
+    }
+}
+
+
+int countpairs_xi_prepared(prepared_catalog *catalog,
+                           const double boxsize,
+                           const int numthreads,
+                           const char *binfile,
+                           results_countpairs_xi *results,
+                           struct config_options *options,
+                           struct extra_options *extra)
+{
+    if(catalog == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    /* The precision is set by the catalog */
+    options->float_type = catalog->float_type;
+    if(options->float_type == sizeof(float)) {
+        return countpairs_xi_prepared_float(catalog,
+                                            boxsize,
+                                            numthreads,
+                                            binfile,
+                                            results,
+                                            options,
+                                            extra);
+    } else {
+        return countpairs_xi_prepared_double(catalog,
+                                             boxsize,
+                                             numthreads,
+                                             binfile,
+                                             results,
+                                             options,
+                                             extra);
+    }
+}
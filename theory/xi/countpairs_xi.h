@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 #include "defs.h" //for struct config_options
+#include "prepared_catalog.h"//for prepared_catalog
 #include <stdint.h> //for uint64_t
 
 
@@ -34,6 +35,27 @@ extern "C" {
                              results_countpairs_xi *results,
                              struct config_options *options,
                              struct extra_options *extra);
+
+    /* Same as countpairs_xi but with a catalog that has already been gridded with prepare_catalog.
+       The catalog must have been prepared in periodic mode, with the same boxsize. */
+    extern int countpairs_xi_prepared(prepared_catalog *catalog,
+                                      const double boxsize,
+                                      const int numthreads,
+                                      const char *binfile,
+                                      results_countpairs_xi *results,
+                                      struct config_options *options,
+                                      struct extra_options *extra);
+
+    /* xi for several bin specifications (one bin file each) from one pass over the pairs (see bin_specs.h).
+       results is an array with one entry for each of the nbinfiles bin files, and each entry is the same as from
+       countpairs_xi with that bin file */
+    extern int countpairs_xi_multi_bins(const int64_t ND1, void * restrict X1, void * restrict Y1, void * restrict Z1,
+                                        const double boxsize,
+                                        const int numthreads,
+                                        const int nbinfiles, const char **binfiles,
+                                        results_countpairs_xi *results,
+                                        struct config_options *options,
+                                        struct extra_options *extra);
     
 #ifdef __cplusplus
 }
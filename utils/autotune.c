@@ -0,0 +1,415 @@
+/* File: autotune.c */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <sys/file.h>
+
+#include "autotune.h"
+#include "cpu_features.h"
+#include "macros.h"
+#include "utils.h"
+
+/* The cpu brand string (cpuid leaves 0x80000002-0x80000004), without the padding and tabs */
+static void get_cpu_model(char *model, const size_t len)
+{
+    int abcd[4] = {0, 0, 0, 0};
+    char brand[49];
+    memset(brand, 0, sizeof(brand));
+    cpuid(abcd, (int) 0x80000000);
+    if((unsigned int) abcd[0] >= 0x80000004u) {
+        for(int leaf=0;leaf<3;leaf++) {
+            cpuid(abcd, (int) (0x80000002u + (unsigned int) leaf));
+            memcpy(brand + 16*leaf, abcd, 16);
+        }
+    }
+    const char *start = brand;
+    while(*start == ' ') {
+        start++;
+    }
+    snprintf(model, len, "%s", *start != '\0' ? start:"unknown");
+    for(size_t i=strlen(model);i>0 && model[i-1] == ' ';i--) {
+        model[i-1] = '\0';
+    }
+    for(char *c=model;*c != '\0';c++) {
+        if(*c == '\t' || *c == '\n') {
+            *c = ' ';
+        }
+    }
+}
+
+void get_autotune_key(autotune_key *key, const char *statistic, const int numthreads, const int64_t np,
+                      const double rmax, const double boxsize, const size_t float_type)
+{
+    memset(key, 0, sizeof(*key));
+    snprintf(key->statistic, sizeof(key->statistic), "%s", statistic);
+    get_cpu_model(key->cpu_model, sizeof(key->cpu_model));
+    key->numthreads = numthreads;
+    key->log2_np = np > 0 ? (int) floor(log2((double) np)):0;
+    key->log2_rmax_ratio = (rmax > 0 && boxsize > 0) ? (int) lround(4.0*log2(rmax/boxsize)):0;
+    key->float_type = (int) float_type;
+}
+
+void get_options_autotune_params(const struct config_options *options, autotune_params *params)
+{
+    params->instruction_set = options->instruction_set;
+    for(int i=0;i<3;i++) {
+        params->bin_refine_factors[i] = options->bin_refine_factors[i];
+    }
+    params->max_cells_per_dim = options->max_cells_per_dim;
+}
+
+void set_options_autotune_params(struct config_options *options, const autotune_params *params)
+{
+    options->instruction_set = params->instruction_set;
+    for(int i=0;i<3;i++) {
+        options->bin_refine_factors[i] = params->bin_refine_factors[i];
+    }
+    options->max_cells_per_dim = params->max_cells_per_dim;
+    set_bin_refine_scheme(options, BINNING_CUST);//the tuned factors must not be replaced by the defaults
+}
+
+/* The cache file, or NULL if neither CORRFUNC_AUTOTUNE_CACHE nor HOME is set */
+static const char *get_autotune_cache_path(char *path, const size_t len)
+{
+    const char *env = getenv(AUTOTUNE_CACHE_ENV);
+    if(env != NULL && env[0] != '\0') {
+        snprintf(path, len, "%s", env);
+        return path;
+    }
+    const char *home = getenv("HOME");
+    if(home == NULL || home[0] == '\0') {
+        return NULL;
+    }
+    snprintf(path, len, "%s/%s", home, AUTOTUNE_CACHE_FILE);
+    return path;
+}
+
+static int read_autotune_cache(const char *path, const autotune_key *key, autotune_params *params)
+{
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL) {
+        return EXIT_FAILURE;
+    }
+    /* Shared lock -> never reads a line that another process is still appending */
+    if(flock(fileno(fp), LOCK_SH) != 0) {
+        fclose(fp);
+        return EXIT_FAILURE;
+    }
+    int status = EXIT_FAILURE;
+    char line[512];
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        if(line[0] == '#') {
+            continue;
+        }
+        autotune_key entry;
+        int instruction_set, refine[3], max_cells;
+        memset(&entry, 0, sizeof(entry));
+        const int nread = sscanf(line, "%15[^\t]\t%63[^\t]\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d",
+                                 entry.statistic, entry.cpu_model, &entry.numthreads, &entry.log2_np, &entry.log2_rmax_ratio,
+                                 &entry.float_type, &instruction_set, &refine[0], &refine[1], &refine[2], &max_cells);
+        if(nread != 11 || memcmp(&entry, key, sizeof(entry)) != 0) {
+            continue;
+        }
+        if(refine[0] < 1 || refine[1] < 1 || refine[2] < 1 || refine[0] > INT8_MAX || refine[1] > INT8_MAX || refine[2] > INT8_MAX
+           || max_cells < 1 || max_cells > UINT16_MAX) {
+            continue;
+        }
+        /* the last match wins */
+        params->instruction_set = instruction_set;
+        for(int i=0;i<3;i++) {
+            params->bin_refine_factors[i] = (int8_t) refine[i];
+        }
+        params->max_cells_per_dim = (uint16_t) max_cells;
+        status = EXIT_SUCCESS;
+    }
+    fclose(fp);
+    return status;
+}
+
+static int write_autotune_cache(const char *path, const autotune_key *key, const autotune_params *params)
+{
+    FILE *fp = fopen(path, "a");
+    if(fp == NULL) {
+        return EXIT_FAILURE;
+    }
+    /* Exclusive lock -> concurrent processes (e.g., the ranks of an MPI job) append whole lines, one at a time. The
+       lock is released by fclose, after the line has been flushed */
+    if(flock(fileno(fp), LOCK_EX) != 0) {
+        fclose(fp);
+        return EXIT_FAILURE;
+    }
+    if(fseek(fp, 0, SEEK_END) != 0 || ftell(fp) == 0) {
+        fprintf(fp, "# Corrfunc autotune cache: statistic cpu numthreads log2(N) 4*log2(rmax/boxsize) float_type "
+                "instruction_set bin_refine_factors[3] max_cells_per_dim\n");
+    }
+    fprintf(fp, "%s\t%s\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n",
+            key->statistic, key->cpu_model, key->numthreads, key->log2_np, key->log2_rmax_ratio, key->float_type,
+            params->instruction_set, params->bin_refine_factors[0], params->bin_refine_factors[1], params->bin_refine_factors[2],
+            params->max_cells_per_dim);
+    return fclose(fp) == 0 ? EXIT_SUCCESS:EXIT_FAILURE;
+}
+
+/* Wall time of one run with params. The grid of the subsample has scale (= side/boxsize) times the cells of the
+   full catalog along each axis -> max_cells_per_dim is scaled by the same amount */
+static int time_autotune_run(struct config_options *trial, const autotune_params *params, const double scale,
+                             autotune_run_func run, void *data, double *seconds)
+{
+    set_options_autotune_params(trial, params);
+    const double max_cells = ceil(scale*params->max_cells_per_dim);
+    trial->max_cells_per_dim = (uint16_t) (max_cells < 1 ? 1:max_cells);
+
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    const int status = run(trial, data);
+    gettimeofday(&t1, NULL);
+    *seconds = ADD_DIFF_TIME(t0, t1);
+    return status;
+}
+
+/* Replaces best (taking best_time) with candidate if that is faster by more than the noise in the timings */
+static int try_autotune_candidate(struct config_options *trial, const autotune_params *candidate, const double scale,
+                                  autotune_run_func run, void *data, autotune_params *best, double *best_time)
+{
+    double seconds;
+    if(time_autotune_run(trial, candidate, scale, run, data, &seconds) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    if(seconds < 0.97*(*best_time)) {
+        *best = *candidate;
+        *best_time = seconds;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* One parameter at a time, starting from the settings in options: the instruction set, the bin refine factors
+   (1-3 along x/y, 1-3 along z) and then max_cells_per_dim */
+static int search_autotune_params(const struct config_options *options, const double scale,
+                                  autotune_run_func run, void *data, autotune_params *best)
+{
+    struct config_options trial = *options;
+    trial.autotune = 0;
+    trial.verbose = 0;
+    trial.c_api_timer = 0;
+    trial.c_cell_timer = 0;
+    trial.cell_timings = NULL;
+    trial.totncells_timings = 0;
+
+    get_options_autotune_params(options, best);
+    double best_time;
+    /* The first run only warms up (page faults, caches) */
+    if(time_autotune_run(&trial, best, scale, run, data, &best_time) != EXIT_SUCCESS ||
+       time_autotune_run(&trial, best, scale, run, data, &best_time) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    /* The compiled-in instruction sets that the cpu supports, up to the one requested */
+    const int32_t isas[] = {
+#ifdef __AVX512F__
+        AVX512F,
+#endif
+#ifdef __AVX__
+        AVX,
+#endif
+#ifdef __SSE4_2__
+        SSE42,
+#endif
+        FALLBACK
+    };
+    const int highest_isa = instrset_detect();
+    const int32_t max_isa = options->instruction_set >= 0 ? options->instruction_set:NUM_ISA;
+    for(size_t i=0;i<sizeof(isas)/sizeof(isas[0]);i++) {
+        if(isas[i] > highest_isa || isas[i] > max_isa || isas[i] == best->instruction_set) {
+            continue;
+        }
+        autotune_params candidate = *best;
+        candidate.instruction_set = isas[i];
+        if(try_autotune_candidate(&trial, &candidate, scale, run, data, best, &best_time) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    const autotune_params start = *best;
+    for(int8_t rxy=1;rxy<=3;rxy++) {
+        for(int8_t rz=1;rz<=3;rz++) {
+            if(rxy == start.bin_refine_factors[0] && rxy == start.bin_refine_factors[1] && rz == start.bin_refine_factors[2]) {
+                continue;
+            }
+            autotune_params candidate = *best;
+            candidate.bin_refine_factors[0] = rxy;
+            candidate.bin_refine_factors[1] = rxy;
+            candidate.bin_refine_factors[2] = rz;
+            if(try_autotune_candidate(&trial, &candidate, scale, run, data, best, &best_time) != EXIT_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    const int max_cells = best->max_cells_per_dim;
+    const int max_cells_candidates[] = {max_cells/2, 2*max_cells};
+    for(int i=0;i<2;i++) {
+        if(max_cells_candidates[i] < 1 || max_cells_candidates[i] > UINT16_MAX) {
+            continue;
+        }
+        autotune_params candidate = *best;
+        candidate.max_cells_per_dim = (uint16_t) max_cells_candidates[i];
+        if(try_autotune_candidate(&trial, &candidate, scale, run, data, best, &best_time) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int get_autotune_params(const autotune_key *key, const struct config_options *options,
+                        const double boxsize, const double side,
+                        autotune_run_func run, void *data, autotune_params *params)
+{
+    char buf[4096];
+    const char *path = get_autotune_cache_path(buf, sizeof(buf));
+    if(path != NULL && read_autotune_cache(path, key, params) == EXIT_SUCCESS) {
+        if(options->verbose) {
+            fprintf(stderr,"Using the tuned settings from `%s': instruction set = %d, bin refine factors = (%d, %d, %d), "
+                    "max cells per dim = %d\n", path, params->instruction_set, params->bin_refine_factors[0],
+                    params->bin_refine_factors[1], params->bin_refine_factors[2], params->max_cells_per_dim);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if(options->verbose) {
+        fprintf(stderr,"Tuning the binning and the instruction set for %s on a subsample (box of side %lf)\n", key->statistic, side);
+    }
+    const double scale = boxsize > 0 ? side/boxsize:1.0;
+    if(search_autotune_params(options, scale, run, data, params) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error: In %s> Could not time the candidate settings for %s\n", __FUNCTION__, key->statistic);
+        return EXIT_FAILURE;
+    }
+    if(options->verbose) {
+        fprintf(stderr,"Tuned settings: instruction set = %d, bin refine factors = (%d, %d, %d), max cells per dim = %d\n",
+                params->instruction_set, params->bin_refine_factors[0], params->bin_refine_factors[1],
+                params->bin_refine_factors[2], params->max_cells_per_dim);
+    }
+
+    /* Not being able to write the cache only costs a search in the next call */
+    if(path == NULL || write_autotune_cache(path, key, params) != EXIT_SUCCESS) {
+        fprintf(stderr,"Warning: In %s> Could not store the tuned settings in the cache `%s' (set %s to a writable file)\n",
+                __FUNCTION__, path == NULL ? "":path, AUTOTUNE_CACHE_ENV);
+    }
+    return EXIT_SUCCESS;
+}
+
+double get_autotune_sample_side(const int64_t np, const double boxsize, const double rmax)
+{
+    if(np <= AUTOTUNE_SAMPLE_SIZE) {
+        return boxsize;
+    }
+    double side = boxsize*cbrt((double) AUTOTUNE_SAMPLE_SIZE/(double) np);
+    if(side < 4.0*rmax) {
+        side = 4.0*rmax;
+    }
+    return side < boxsize ? side:boxsize;
+}
+
+void free_autotune_sample(autotune_sample *sample)
+{
+    free(sample->X);
+    free(sample->Y);
+    free(sample->Z);
+    for(int64_t w=0;w<sample->weights.num_weights;w++) {
+        free(sample->weights.weights[w]);
+    }
+    memset(sample, 0, sizeof(*sample));
+}
+
+/* x - min, within [0, side) also after the rounding of the subtraction */
+static inline double autotune_shift(const double x, const double min, const double side)
+{
+    const double shifted = x - min;
+    return shifted < side ? shifted:nextafter(side, 0.0);
+}
+
+/* Same as autotune_shift, after the rounding to float (a double just below side can round up to side) */
+static inline float autotune_shift_float(const float x, const double min, const float side)
+{
+    const float shifted = (float) (x - min);
+    return shifted < side ? shifted:nextafterf(side, 0.0f);
+}
+
+#define AUTOTUNE_INSIDE_CUBE(X, Y, Z, i)  ((X)[i] >= min[0] && (X)[i] < min[0] + side && \
+                                           (Y)[i] >= min[1] && (Y)[i] < min[1] + side && \
+                                           (Z)[i] >= min[2] && (Z)[i] < min[2] + side)
+
+int autotune_subsample(const int64_t np, const void *X, const void *Y, const void *Z, const weight_struct *weights,
+                       const size_t float_type, const double min[3], const double side,
+                       autotune_sample *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+    if( ! (float_type == sizeof(float) || float_type == sizeof(double))) {
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, float_type);
+        return EXIT_FAILURE;
+    }
+    const int is_double = float_type == sizeof(double);
+
+    int64_t nsample = 0;
+    for(int64_t i=0;i<np;i++) {
+        const int inside = is_double ? AUTOTUNE_INSIDE_CUBE((const double *) X, (const double *) Y, (const double *) Z, i)
+                                     : AUTOTUNE_INSIDE_CUBE((const float *) X, (const float *) Y, (const float *) Z, i);
+        nsample += inside;
+    }
+
+    const int64_t num_weights = weights != NULL ? weights->num_weights:0;
+    const int64_t nalloc = nsample > 0 ? nsample:1;
+    sample->X = malloc(float_type*nalloc);
+    sample->Y = malloc(float_type*nalloc);
+    sample->Z = malloc(float_type*nalloc);
+    sample->weights.num_weights = num_weights;
+    sample->weights.num_integer_weights = weights != NULL ? weights->num_integer_weights:0;
+    int status = (sample->X == NULL || sample->Y == NULL || sample->Z == NULL) ? EXIT_FAILURE:EXIT_SUCCESS;
+    for(int64_t w=0;w<num_weights;w++) {
+        sample->weights.weights[w] = malloc(float_type*nalloc);
+        if(sample->weights.weights[w] == NULL) {
+            status = EXIT_FAILURE;
+        }
+    }
+    if(status != EXIT_SUCCESS) {
+        fprintf(stderr,"Error: In %s> Could not allocate memory for the subsample of %"PRId64" particles\n", __FUNCTION__, nsample);
+        free_autotune_sample(sample);
+        return EXIT_FAILURE;
+    }
+
+    /* The positions within the sub-cube, relative to its corner */
+    int64_t index = 0;
+    for(int64_t i=0;i<np;i++) {
+        if(is_double) {
+            const double *x = (const double *) X, *y = (const double *) Y, *z = (const double *) Z;
+            if( ! AUTOTUNE_INSIDE_CUBE(x, y, z, i)) continue;
+            ((double *) sample->X)[index] = autotune_shift(x[i], min[0], side);
+            ((double *) sample->Y)[index] = autotune_shift(y[i], min[1], side);
+            ((double *) sample->Z)[index] = autotune_shift(z[i], min[2], side);
+        } else {
+            const float *x = (const float *) X, *y = (const float *) Y, *z = (const float *) Z;
+            if( ! AUTOTUNE_INSIDE_CUBE(x, y, z, i)) continue;
+            ((float *) sample->X)[index] = autotune_shift_float(x[i], min[0], (float) side);
+            ((float *) sample->Y)[index] = autotune_shift_float(y[i], min[1], (float) side);
+            ((float *) sample->Z)[index] = autotune_shift_float(z[i], min[2], (float) side);
+        }
+        for(int64_t w=0;w<num_weights;w++) {
+            memcpy((char *) sample->weights.weights[w] + index*float_type, (const char *) weights->weights[w] + i*float_type, float_type);
+        }
+        index++;
+    }
+    sample->np = nsample;
+    sample->side = side;
+    return EXIT_SUCCESS;
+}
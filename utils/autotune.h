@@ -0,0 +1,93 @@
+/* File: autotune.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "defs.h"//for struct config_options and weight_struct
+#include <stdint.h>
+
+    /* Bin refine factors, max_cells_per_dim and instruction set tuned for
+       this machine, for the theory pair-counters (DD, DDrppi, wp and xi)
+       with options->autotune and the default binning (BINNING_DFL).
+
+       The settings are cached on disk, keyed by the CPU model, the number of
+       threads, the statistic, the precision, N and rmax/boxsize. On a miss,
+       the candidates are timed on a subsample of the catalog, and the fastest
+       is stored. The subsample is the particles within a sub-cube of the box
+       -> the number density, and so the cost per cell, are the same as for
+       the full catalog.
+
+       The cache is the file in the environment variable
+       CORRFUNC_AUTOTUNE_CACHE, or ~/.corrfunc_autotune. Entries are
+       appended and the last match wins -> to re-tune, delete the line (or
+       the file). The file is locked (flock) while it is read or appended
+       to, so several processes can share it.
+     */
+
+#define AUTOTUNE_CACHE_ENV          "CORRFUNC_AUTOTUNE_CACHE"
+#define AUTOTUNE_CACHE_FILE         ".corrfunc_autotune"
+#define AUTOTUNE_SAMPLE_SIZE        (1 << 18)//particles in the subsample (on average)
+
+    typedef struct{
+        char statistic[16];
+        char cpu_model[64];
+        int numthreads;
+        int log2_np;/* floor(log2(N)) */
+        int log2_rmax_ratio;/* lround(4*log2(rmax/boxsize)) -> steps of 2^(1/4) in rmax/boxsize */
+        int float_type;
+    } autotune_key;
+
+    typedef struct{
+        int32_t instruction_set;
+        int8_t bin_refine_factors[3];
+        uint16_t max_cells_per_dim;
+    } autotune_params;
+
+    /* A subsample of a catalog: the particles within the cube [min, min + side) (see autotune_subsample) */
+    typedef struct{
+        int64_t np;
+        void *X;
+        void *Y;
+        void *Z;
+        weight_struct weights;
+        double side;
+    } autotune_sample;
+
+    /* Runs the statistic once, on the subsample(s) in data, with the binning and the instruction set in options */
+    typedef int (*autotune_run_func)(struct config_options *options, void *data);
+
+    extern void get_autotune_key(autotune_key *key, const char *statistic, const int numthreads, const int64_t np,
+                                 const double rmax, const double boxsize, const size_t float_type);
+
+    /* The cached settings for key, or the fastest of the candidates (timed with run) which are then cached. boxsize
+       and side are the sizes of the full catalog and of the subsample, to scale max_cells_per_dim for the runs */
+    extern int get_autotune_params(const autotune_key *key, const struct config_options *options,
+                                   const double boxsize, const double side,
+                                   autotune_run_func run, void *data, autotune_params *params) __attribute__((warn_unused_result));
+
+    extern void get_options_autotune_params(const struct config_options *options, autotune_params *params);
+    extern void set_options_autotune_params(struct config_options *options, const autotune_params *params);
+
+    /* The side of the sub-cube of a box of size boxsize with np particles that holds ~AUTOTUNE_SAMPLE_SIZE of them,
+       but at least 4*rmax (and at most boxsize) */
+    extern double get_autotune_sample_side(const int64_t np, const double boxsize, const double rmax);
+
+    /* Copies the particles (and weights) within [min[i], min[i] + side) along every axis into sample. The positions
+       are shifted by -min -> a periodic box of size side */
+    extern int autotune_subsample(const int64_t np, const void *X, const void *Y, const void *Z, const weight_struct *weights,
+                                  const size_t float_type, const double min[3], const double side,
+                                  autotune_sample *sample) __attribute__((warn_unused_result));
+    extern void free_autotune_sample(autotune_sample *sample);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,155 @@
+/* File: avx512_calls.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Wrappers for the 512-bit (AVX512F) kernels. Unlike AVX, the comparisons
+  produce mask registers (AVX512_MASK, one bit per lane) instead of vectors ->
+  the cuts are combined by passing the mask of the previous cut into the next
+  comparison, the pairs are counted by a popcount of the mask, and the sums
+  (rpavg, weightavg) are masked reductions. The remainder of the j-loop is a
+  masked (zeroing) load of the first n lanes, which never faults on the lanes
+  that are masked out -> no scalar remainder loop.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "function_precision.h"
+
+#if defined(__GNUC__) || defined(__GNUG__)
+#define AVX512_MASK_BITCOUNT(X)             __builtin_popcount((unsigned int) (X))
+#else
+#define AVX512_MASK_BITCOUNT(X)             _mm_popcnt_u32((unsigned int) (X))
+#endif
+/* Index of the lowest lane set in a (non-zero) mask -> loops over the lanes of a mask */
+#define AVX512_MASK_FIRST_LANE(X)           __builtin_ctz((unsigned int) (X))
+
+#ifndef DOUBLE_PREC
+
+#define DOUBLE                              float
+#define AVX512_NVEC                         16
+#define AVX512_MASK                         __mmask16
+#define AVX512_FLOATS                       __m512
+#define AVX512_INTS                         __m512i
+
+#define AVX512_LOAD_FLOATS_UNALIGNED(X)                 _mm512_loadu_ps(X)
+#define AVX512_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)      _mm512_maskz_loadu_ps(MASK,X)
+#define AVX512_MULTIPLY_FLOATS(X,Y)                     _mm512_mul_ps(X,Y)
+#define AVX512_DIVIDE_FLOATS(X,Y)                       _mm512_div_ps(X,Y)
+#define AVX512_RECIPROCAL_FLOATS(X)                     _mm512_rcp14_ps(X)
+#define AVX512_SUBTRACT_FLOATS(X,Y)                     _mm512_sub_ps(X,Y)
+#define AVX512_ADD_FLOATS(X,Y)                          _mm512_add_ps(X,Y)
+#define AVX512_SQRT_FLOAT(X)                            _mm512_sqrt_ps(X)
+#define AVX512_SQUARE_FLOAT(X)                          _mm512_mul_ps(X,X)
+#define AVX512_SET_FLOAT(X)                             _mm512_set1_ps(X)
+#define AVX512_TRUNCATE_FLOAT_TO_INT(X)                 _mm512_cvttps_epi32(X)
+#define AVX512_CONVERT_INT_TO_FLOAT(X)                  _mm512_cvtepi32_ps(X)
+#define AVX512_SETZERO_FLOAT()                          _mm512_setzero_ps()
+#define AVX512_MIN_FLOATS(X,Y)                          _mm512_min_ps(X,Y)
+#define AVX512_MAX_FLOATS(X,Y)                          _mm512_max_ps(X,Y)
+    // floor(log2(|X|)) and the mantissa in [1, 2) -> X = mantissa * 2^exponent
+#define AVX512_GETEXP_FLOAT(X)                          _mm512_getexp_ps(X)
+#define AVX512_GETMANT_FLOAT(X)                         _mm512_getmant_ps(X, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero)
+#define AVX512_STORE_FLOATS_TO_MEMORY(X,Y)              _mm512_storeu_ps(X,Y)
+
+    // X OP Y -> mask
+#define AVX512_COMPARE_FLOATS(X,Y,OP)                   _mm512_cmp_ps_mask(X,Y,OP)
+    // (X OP Y) for the lanes set in MASK, zero otherwise
+#define AVX512_MASK_COMPARE_FLOATS(MASK,X,Y,OP)         _mm512_mask_cmp_ps_mask(MASK,X,Y,OP)
+
+#define AVX512_MASK_REDUCE_ADD_FLOATS(MASK,X)           _mm512_mask_reduce_add_ps(MASK,X)
+#define AVX512_REDUCE_ADD_FLOATS(X)                     _mm512_reduce_add_ps(X)
+    // X + Y for the lanes set in MASK, SRC otherwise
+#define AVX512_MASK_ADD_FLOATS(SRC,MASK,X,Y)            _mm512_mask_add_ps(SRC,MASK,X,Y)
+#define AVX512_MASKZ_COMPRESS_FLOATS(MASK,X)            _mm512_maskz_compress_ps(MASK,X)
+#define AVX512_MASKZ_EXPAND_FLOATS(MASK,X)              _mm512_maskz_expand_ps(MASK,X)
+    // Y for the lanes set in MASK -> X; the lanes of Y set in MASK, stored contiguously from X
+#define AVX512_MASK_STORE_FLOATS_TO_MEMORY(X,MASK,Y)    _mm512_mask_storeu_ps(X,MASK,Y)
+#define AVX512_MASK_COMPRESS_STORE_FLOATS(X,MASK,Y)     _mm512_mask_compressstoreu_ps(X,MASK,Y)
+#define AVX512_BLEND_FLOATS_WITH_MASK(MASK,FALSEVALUE,TRUEVALUE) _mm512_mask_blend_ps(MASK,FALSEVALUE,TRUEVALUE)
+
+    //Absolute value
+#define AVX512_ABS_FLOAT(X)                             _mm512_abs_ps(X)
+
+    // X & Y (AVX512F has no _mm512_and_ps), and the number of bits set in every lane (AVX512VPOPCNTDQ)
+#define AVX512_BITWISE_AND(X,Y)                         _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(X), _mm512_castps_si512(Y)))
+#if defined(__AVX512VPOPCNTDQ__)
+#define AVX512_POPCOUNT_FLOATS(X)                       _mm512_cvtepi32_ps(_mm512_popcnt_epi32(_mm512_castps_si512(X)))
+#endif
+
+#else //DOUBLE PRECISION CALCULATIONS
+
+#define DOUBLE                              double
+#define AVX512_NVEC                         8
+#define AVX512_MASK                         __mmask8
+#define AVX512_FLOATS                       __m512d
+#define AVX512_INTS                         __m256i
+
+#define AVX512_LOAD_FLOATS_UNALIGNED(X)                 _mm512_loadu_pd(X)
+#define AVX512_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)      _mm512_maskz_loadu_pd(MASK,X)
+#define AVX512_MULTIPLY_FLOATS(X,Y)                     _mm512_mul_pd(X,Y)
+#define AVX512_DIVIDE_FLOATS(X,Y)                       _mm512_div_pd(X,Y)
+#define AVX512_RECIPROCAL_FLOATS(X)                     _mm512_rcp14_pd(X)
+#define AVX512_SUBTRACT_FLOATS(X,Y)                     _mm512_sub_pd(X,Y)
+#define AVX512_ADD_FLOATS(X,Y)                          _mm512_add_pd(X,Y)
+#define AVX512_SQRT_FLOAT(X)                            _mm512_sqrt_pd(X)
+#define AVX512_SQUARE_FLOAT(X)                          _mm512_mul_pd(X,X)
+#define AVX512_SET_FLOAT(X)                             _mm512_set1_pd(X)
+#define AVX512_TRUNCATE_FLOAT_TO_INT(X)                 _mm512_cvttpd_epi32(X)
+#define AVX512_CONVERT_INT_TO_FLOAT(X)                  _mm512_cvtepi32_pd(X)
+#define AVX512_SETZERO_FLOAT()                          _mm512_setzero_pd()
+#define AVX512_MIN_FLOATS(X,Y)                          _mm512_min_pd(X,Y)
+#define AVX512_MAX_FLOATS(X,Y)                          _mm512_max_pd(X,Y)
+    // floor(log2(|X|)) and the mantissa in [1, 2) -> X = mantissa * 2^exponent
+#define AVX512_GETEXP_FLOAT(X)                          _mm512_getexp_pd(X)
+#define AVX512_GETMANT_FLOAT(X)                         _mm512_getmant_pd(X, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero)
+#define AVX512_STORE_FLOATS_TO_MEMORY(X,Y)              _mm512_storeu_pd(X,Y)
+
+    // X OP Y -> mask
+#define AVX512_COMPARE_FLOATS(X,Y,OP)                   _mm512_cmp_pd_mask(X,Y,OP)
+    // (X OP Y) for the lanes set in MASK, zero otherwise
+#define AVX512_MASK_COMPARE_FLOATS(MASK,X,Y,OP)         _mm512_mask_cmp_pd_mask(MASK,X,Y,OP)
+
+#define AVX512_MASK_REDUCE_ADD_FLOATS(MASK,X)           _mm512_mask_reduce_add_pd(MASK,X)
+#define AVX512_REDUCE_ADD_FLOATS(X)                     _mm512_reduce_add_pd(X)
+    // X + Y for the lanes set in MASK, SRC otherwise
+#define AVX512_MASK_ADD_FLOATS(SRC,MASK,X,Y)            _mm512_mask_add_pd(SRC,MASK,X,Y)
+#define AVX512_MASKZ_COMPRESS_FLOATS(MASK,X)            _mm512_maskz_compress_pd(MASK,X)
+#define AVX512_MASKZ_EXPAND_FLOATS(MASK,X)              _mm512_maskz_expand_pd(MASK,X)
+    // Y for the lanes set in MASK -> X; the lanes of Y set in MASK, stored contiguously from X
+#define AVX512_MASK_STORE_FLOATS_TO_MEMORY(X,MASK,Y)    _mm512_mask_storeu_pd(X,MASK,Y)
+#define AVX512_MASK_COMPRESS_STORE_FLOATS(X,MASK,Y)     _mm512_mask_compressstoreu_pd(X,MASK,Y)
+#define AVX512_BLEND_FLOATS_WITH_MASK(MASK,FALSEVALUE,TRUEVALUE) _mm512_mask_blend_pd(MASK,FALSEVALUE,TRUEVALUE)
+
+    //Absolute value
+#define AVX512_ABS_FLOAT(X)                             _mm512_abs_pd(X)
+
+#define AVX512_BITWISE_AND(X,Y)                         _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(X), _mm512_castpd_si512(Y)))
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512DQ__)
+#define AVX512_POPCOUNT_FLOATS(X)                       _mm512_cvtepi64_pd(_mm512_popcnt_epi64(_mm512_castpd_si512(X)))
+#endif
+
+#endif //DOUBLE_PREC
+
+/* Mask with the first n (0 <= n) lanes set -> the masked loads for the last, partial, vector */
+static inline AVX512_MASK avx512_mask_first_n(const int64_t n)
+{
+    return n >= AVX512_NVEC ? (AVX512_MASK) ~((AVX512_MASK) 0):(AVX512_MASK) ((1u << n) - 1u);
+}
+
+#ifdef __cplusplus
+}
+#endif
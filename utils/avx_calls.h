@@ -56,8 +56,8 @@ extern "C" {
 #define AVX_LOG2_FLOAT(X)                _mm256_log2_ps(X)
 #define AVX_RECIPROCAL_FLOATS(X)         _mm256_rcp_ps(X)
 
-#define AVX_BROADCAST_FLOAT(X)           _mm256_broadcast_ss(X);
-#define AVX_SET_FLOAT(X)                 _mm256_set1_ps(X);
+#define AVX_BROADCAST_FLOAT(X)           _mm256_broadcast_ss(X)
+#define AVX_SET_FLOAT(X)                 _mm256_set1_ps(X)
 
 
     // X OP Y
@@ -72,6 +72,8 @@ extern "C" {
 
 #define AVX_BLEND_FLOATS_WITH_MASK(FALSEVALUE,TRUEVALUE,MASK) _mm256_blendv_ps(FALSEVALUE,TRUEVALUE,MASK)
 #define AVX_MASKSTORE_FLOATS(dest, mask, source)   _mm256_maskstore_ps(dest, mask, source)
+    // X for the lanes set in MASK (a comparison), zero otherwise -> the masked lanes are not read
+#define AVX_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)   _mm256_maskload_ps(X, _mm256_castps_si256(MASK))
 
 //Trig
 #ifdef  __INTEL_COMPILER
@@ -81,8 +83,9 @@ extern "C" {
 #define AVX_ARC_COSINE(X, order)                  inv_cosine_avx(X, order)
 #endif
 
-    //Max
+    //Max and min (the second operand if either is NaN)
 #define AVX_MAX_FLOATS(X,Y)               _mm256_max_ps(X,Y)
+#define AVX_MIN_FLOATS(X,Y)               _mm256_min_ps(X,Y)
 
 
   //Absolute value
@@ -91,6 +94,10 @@ extern "C" {
     //Casting (does not actual convert between types)
 #define AVX_CAST_FLOAT_TO_INT(X)          _mm256_castps_si256(X)
 #define AVX_CAST_INT_TO_FLOAT(X)          _mm256_castsi256_ps(X)
+    //Conversion (the values, e.g., the bins from AVX_TRUNCATE_FLOAT_TO_INT)
+#define AVX_CONVERT_INT_TO_FLOAT(X)       _mm256_cvtepi32_ps(X)
+    //log2(X) for X > 0 to within 0.09, from the exponent and the (linear) mantissa bits (see bin_lookup.h)
+#define AVX_APPROX_LOG2_FLOAT(X)          _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(X)), _mm256_set1_ps(1.0f/8388608.0f)), _mm256_set1_ps(127.0f))
 
     //Streaming store
 #define AVX_STREAMING_STORE_FLOATS(X,Y)   _mm256_stream_ps(X,Y)
@@ -126,13 +133,14 @@ extern "C" {
 #define AVX_XOR_FLOATS(X,Y)               _mm256_xor_pd(X,Y)
 #define AVX_AND_NOT(X,Y)                  _mm256_andnot_pd((X),(Y))  //~X & Y
 
-#define AVX_BROADCAST_FLOAT(X)            _mm256_broadcast_sd(X);
-#define AVX_SET_FLOAT(X)                  _mm256_set1_pd(X);
+#define AVX_BROADCAST_FLOAT(X)            _mm256_broadcast_sd(X)
+#define AVX_SET_FLOAT(X)                  _mm256_set1_pd(X)
 //MoveMask
 #define AVX_TEST_COMPARISON(X)            _mm256_movemask_pd(X)
 
 #define AVX_BLEND_FLOATS_WITH_MASK(FALSEVALUE,TRUEVALUE,MASK) _mm256_blendv_pd(FALSEVALUE,TRUEVALUE,MASK)
 #define AVX_MASKSTORE_FLOATS(dest, mask, source)   _mm256_maskstore_pd(dest, mask, source)
+#define AVX_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)   _mm256_maskload_pd(X, _mm256_castpd_si256(MASK))
 
 //Trig
 #ifdef  __INTEL_COMPILER
@@ -141,8 +149,9 @@ extern "C" {
 #define AVX_ARC_COSINE(X, order)                  inv_cosine_avx(X, order)
 #endif
 
-    //Max
+    //Max and min (the second operand if either is NaN)
 #define AVX_MAX_FLOATS(X,Y)               _mm256_max_pd(X,Y)
+#define AVX_MIN_FLOATS(X,Y)               _mm256_min_pd(X,Y)
 
   //Absolute value
 #define AVX_ABS_FLOAT(X)                  _mm256_max_pd(_mm256_sub_pd(_mm256_setzero_pd(), X), X)
@@ -150,6 +159,10 @@ extern "C" {
     //Casting (does not actual convert between types)
 #define AVX_CAST_FLOAT_TO_INT(X)          _mm256_castpd_si256(X)
 #define AVX_CAST_INT_TO_FLOAT(X)          _mm256_castsi256_pd(X)
+    //Conversion (the values, e.g., the bins from AVX_TRUNCATE_FLOAT_TO_INT)
+#define AVX_CONVERT_INT_TO_FLOAT(X)       _mm256_cvtepi32_pd(X)
+    //Same as the float version, from the bits of X rounded to float -> AVX has no 64-bit integer conversions
+#define AVX_APPROX_LOG2_FLOAT(X)          _mm256_cvtps_pd(_mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(_mm256_cvtpd_ps(X))), _mm_set1_ps(1.0f/8388608.0f)), _mm_set1_ps(127.0f)))
 
     //Streaming store
 #define AVX_STREAMING_STORE_FLOATS(X,Y)   _mm256_stream_pd(X,Y)
@@ -157,6 +170,31 @@ extern "C" {
 
 #endif //DOUBLE_PREC
 
+/* Comparison mask with the first n (0 <= n) lanes set -> the masked loads for the last, partial, vector */
+static inline AVX_FLOATS avx_mask_first_n(const int64_t n)
+{
+    DOUBLE lanes[AVX_NVEC];
+    for(int jj=0;jj<AVX_NVEC;jj++) {
+        lanes[jj] = (DOUBLE) jj;
+    }
+    return AVX_COMPARE_FLOATS(AVX_LOAD_FLOATS_UNALIGNED(lanes), AVX_SET_FLOAT((DOUBLE) (n < AVX_NVEC ? n:AVX_NVEC)), _CMP_LT_OQ);
+}
+
+/* The lanes of Y set in MASK (a comparison), stored contiguously from X -> the number of lanes stored (AVX has no compress) */
+static inline int avx_mask_compress_store(DOUBLE *X, const AVX_FLOATS MASK, const AVX_FLOATS Y)
+{
+    DOUBLE lanes[AVX_NVEC];
+    AVX_STORE_FLOATS_TO_MEMORY(lanes, Y);
+    const int bits = AVX_TEST_COMPARISON(MASK);
+    int n = 0;
+    for(int jj=0;jj<AVX_NVEC;jj++) {
+        if(bits & (1 << jj)) {
+            X[n++] = lanes[jj];
+        }
+    }
+    return n;
+}
+
 #ifndef  __INTEL_COMPILER
 #include "fast_acos.h"
     
@@ -0,0 +1,176 @@
+/* File: bin_specs.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Several bin specifications (e.g., linear, logarithmic and fine bins) from one pass over the pairs, for DD,
+  DDrppi, wp and xi (the *_multi_bins functions).
+
+  The pairs are counted once, in the merged bins between all the bin edges of all the specifications (up to
+  the largest rmax). Every bin of a specification is a run of consecutive merged bins -> the pair counts for
+  each specification are sums over the merged bins, and are identical to the pair counts from a separate pass
+  with only that specification. The average separations and weights are averages over the same pairs and
+  only differ by round-off.
+
+  The bins follow setup_bins: rupp[0] is rmin, and bin i (1 <= i < nbin) holds the pairs with
+  rupp[i-1] <= r < rupp[i].
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "utils.h"//for setup_bins
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int compare_bin_edges(const void *a, const void *b)
+{
+    const double x = *((const double *) a), y = *((const double *) b);
+    return (x > y) - (x < y);
+}
+
+/* Reads every bin file into (nbins[k], rupp[k]), and merges all the bin edges into one sorted list without
+   duplicates (merged, with nmerged edges). On success, the caller frees rupp[0...nbinfiles-1] and merged */
+static inline int setup_merged_bins(const int nbinfiles, const char **binfiles, int *nbins, double **rupp,
+                                    int *nmerged, double **merged)
+{
+    if(nbinfiles < 1 || binfiles == NULL) {
+        fprintf(stderr,"Error: In %s> Need at least one bin file. Found nbinfiles = %d\n", __FUNCTION__, nbinfiles);
+        return EXIT_FAILURE;
+    }
+
+    int64_t nedges = 0;
+    for(int k=0;k<nbinfiles;k++) {
+        double rmin, rmax;
+        rupp[k] = NULL;
+        int status = setup_bins(binfiles[k], &rmin, &rmax, &nbins[k], &rupp[k]);
+        if(status == EXIT_SUCCESS && ! (rmin >= 0.0 && rmax > 0.0 && rmin < rmax && nbins[k] > 1)) {
+            fprintf(stderr,"Error: Could not setup with R bins correctly from `%s'. (rmin = %lf, rmax = %lf, with nbins = %d). "
+                    "Expected non-zero rmin/rmax with rmax > rmin and nbins >=1 \n", binfiles[k], rmin, rmax, nbins[k]);
+            status = EXIT_FAILURE;
+        }
+        for(int i=1;status == EXIT_SUCCESS && i<nbins[k];i++) {
+            if( ! (rupp[k][i] > rupp[k][i-1])) {
+                fprintf(stderr,"Error: In %s> The bin edges in `%s' must increase. Found %lf after %lf\n",
+                        __FUNCTION__, binfiles[k], rupp[k][i], rupp[k][i-1]);
+                status = EXIT_FAILURE;
+            }
+        }
+        if(status != EXIT_SUCCESS) {
+            for(int j=0;j<k;j++) {
+                free(rupp[j]);
+            }
+            return EXIT_FAILURE;
+        }
+        nedges += nbins[k];
+    }
+
+    double *edges = my_malloc(sizeof(*edges), nedges);
+    if(edges == NULL) {
+        for(int k=0;k<nbinfiles;k++) {
+            free(rupp[k]);
+        }
+        return EXIT_FAILURE;
+    }
+    nedges = 0;
+    for(int k=0;k<nbinfiles;k++) {
+        for(int i=0;i<nbins[k];i++) {
+            edges[nedges++] = rupp[k][i];
+        }
+    }
+    qsort(edges, nedges, sizeof(*edges), compare_bin_edges);
+    int n = 0;
+    for(int64_t i=0;i<nedges;i++) {
+        if(n == 0 || edges[i] > edges[n-1]) {/* sorted -> skips the duplicates */
+            edges[n++] = edges[i];
+        }
+    }
+    *nmerged = n;
+    *merged = edges;
+    return EXIT_SUCCESS;
+}
+
+/* map[u] is the bin of the specification (nbin, rupp) that holds the merged bin u (1 <= u < nmerged), or -1 when
+   the merged bin is outside [rupp[0], rupp[nbin-1]) */
+static inline void get_merged_bin_map(const int nmerged, const double *merged, const int nbin, const double *rupp, int *map)
+{
+    map[0] = -1;
+    int bin = 1;
+    for(int u=1;u<nmerged;u++) {
+        while(bin < nbin && rupp[bin] < merged[u]) {
+            bin++;
+        }
+        map[u] = (bin < nbin && merged[u-1] >= rupp[0]) ? bin:-1;
+    }
+}
+
+/* Sums the pair counts in the merged bins into the bins of one specification, with the average separations and weights
+   (either may be NULL) weighted by the pair counts. Every bin holds nblock values (npibin + 1 for DDrppi, 1 otherwise),
+   of which the first nused are valid. Fills all the nbin*nblock values of npairs, rpavg and weightavg */
+static inline void rebin_merged_pairs(const int nmerged, const int *map, const int nbin, const int nblock, const int nused,
+                                      const uint64_t *merged_npairs, const double *merged_rpavg, const double *merged_weightavg,
+                                      uint64_t *npairs, double *rpavg, double *weightavg)
+{
+    for(int64_t i=0;i<(int64_t) nbin*nblock;i++) {
+        npairs[i] = 0;
+        if(rpavg != NULL) {
+            rpavg[i] = 0.0;
+        }
+        if(weightavg != NULL) {
+            weightavg[i] = 0.0;
+        }
+    }
+    for(int u=1;u<nmerged;u++) {
+        if(map[u] < 0) continue;
+        for(int j=0;j<nused;j++) {
+            const int64_t src = (int64_t) u*nblock + j;
+            const int64_t dst = (int64_t) map[u]*nblock + j;
+            npairs[dst] += merged_npairs[src];
+            if(rpavg != NULL) {
+                rpavg[dst] += merged_rpavg[src] * merged_npairs[src];
+            }
+            if(weightavg != NULL) {
+                weightavg[dst] += merged_weightavg[src] * merged_npairs[src];
+            }
+        }
+    }
+    for(int64_t i=0;i<(int64_t) nbin*nblock;i++) {
+        if(npairs[i] > 0) {
+            if(rpavg != NULL) {
+                rpavg[i] /= (double) npairs[i];
+            }
+            if(weightavg != NULL) {
+                weightavg[i] /= (double) npairs[i];
+            }
+        }
+    }
+}
+
+/* Same as rebin_merged_pairs for the pair counts of every pair of regions (see region_labels.h). The merged histograms
+   hold merged_nbin values per pair of regions and the histograms of the specification hold region_nbin values */
+static inline void rebin_merged_region_npairs(const int nmerged, const int *map, const int nbin, const int nblock, const int nused,
+                                              const int32_t nregions, const int64_t merged_nbin, const uint64_t *merged_region_npairs,
+                                              const int64_t region_nbin, uint64_t *region_npairs)
+{
+    for(int64_t ij=0;ij<(int64_t) nregions*nregions;ij++) {
+        uint64_t *dst = region_npairs + ij*region_nbin;
+        for(int64_t k=0;k<region_nbin;k++) {
+            dst[k] = 0;
+        }
+        rebin_merged_pairs(nmerged, map, nbin, nblock, nused, merged_region_npairs + ij*merged_nbin, NULL, NULL,
+                           dst, NULL, NULL);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
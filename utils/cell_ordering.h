@@ -0,0 +1,159 @@
+/* File: cell_ordering.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Orderings for the 3-D -> 1-D conversion of the cell index (the
+  BINNING_ORD_MASK bits of options->binning_flags).
+
+  The lattices are stored (and traversed by the pair-counters) in the
+  order of the 1-D cell index. With the default row-major ordering, the
+  cells (ix, iy, iz) and (ix+1, iy, iz) are nmesh_y*nmesh_z apart. With the
+  Morton (Z-order) and Hilbert orderings, every cell is instead assigned
+  its rank along the space-filling curve. Cells that are close in 3-D
+  are then (mostly) close in memory, and the neighbour cells opened by one
+  thread are more likely to still be in cache.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "defs.h"
+#include "utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Morton key -> interleave the bits (x is the most significant) */
+static inline uint64_t morton_key_3d(const uint32_t ix, const uint32_t iy, const uint32_t iz, const int nbits)
+{
+    uint64_t key = 0;
+    for(int b=nbits-1;b>=0;b--) {
+        key = (key << 3) | ((uint64_t) ((ix >> b) & 1) << 2) | ((uint64_t) ((iy >> b) & 1) << 1) | (uint64_t) ((iz >> b) & 1);
+    }
+    return key;
+}
+
+/* Hilbert key -> transform the coordinates into the "transposed" Hilbert index
+   (J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 381 (2004))
+   and then interleave the bits exactly like the Morton key */
+static inline uint64_t hilbert_key_3d(const uint32_t ix, const uint32_t iy, const uint32_t iz, const int nbits)
+{
+    uint32_t X[3] = {ix, iy, iz};
+    const uint32_t M = (uint32_t) 1 << (nbits - 1);
+
+    /* Inverse undo */
+    for(uint32_t Q=M;Q>1;Q>>=1) {
+        const uint32_t P = Q - 1;
+        for(int i=0;i<3;i++) {
+            if(X[i] & Q) {
+                X[0] ^= P;
+            } else {
+                const uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    /* Gray encode */
+    for(int i=1;i<3;i++) {
+        X[i] ^= X[i-1];
+    }
+    uint32_t t = 0;
+    for(uint32_t Q=M;Q>1;Q>>=1) {
+        if(X[2] & Q) {
+            t ^= Q - 1;
+        }
+    }
+    for(int i=0;i<3;i++) {
+        X[i] ^= t;
+    }
+
+    return morton_key_3d(X[0], X[1], X[2], nbits);
+}
+
+typedef struct{
+    uint64_t key;
+    int64_t index;
+} cell_ordering_key;
+
+static inline int compare_cell_ordering_keys(const void *a, const void *b)
+{
+    const uint64_t ka = ((const cell_ordering_key *) a)->key;
+    const uint64_t kb = ((const cell_ordering_key *) b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+/* Creates the table mapping the row-major cell index, ix*nmesh_y*nmesh_z + iy*nmesh_z + iz,
+   to the cell index for the requested ordering. For the row-major ordering, *cell_order
+   is set to NULL (the table would be the identity). The table must be freed by the caller */
+static inline int get_cell_ordering_table(const int nmesh_x, const int nmesh_y, const int nmesh_z, const int8_t ordering,
+                                          int64_t **cell_order)
+{
+    *cell_order = NULL;
+    if(ordering == BINNING_ORD_ROWMAJOR) {
+        return EXIT_SUCCESS;
+    }
+    if( ! (ordering == BINNING_ORD_MORTON || ordering == BINNING_ORD_HILBERT)) {
+        fprintf(stderr,"Error: In %s> Unknown cell ordering = %d. Valid values are %d (row-major), %d (Morton) and %d (Hilbert)\n",
+                __FUNCTION__, ordering, BINNING_ORD_ROWMAJOR, BINNING_ORD_MORTON, BINNING_ORD_HILBERT);
+        return EXIT_FAILURE;
+    }
+
+    const int max_nmesh = nmesh_x > nmesh_y ? (nmesh_x > nmesh_z ? nmesh_x:nmesh_z):(nmesh_y > nmesh_z ? nmesh_y:nmesh_z);
+    int nbits = 1;
+    while(((int64_t) 1 << nbits) < max_nmesh) {
+        nbits++;
+    }
+    XRETURN(3*nbits <= 64, EXIT_FAILURE, "Number of cells per dimension = %d is too large for a %d bit key\n", max_nmesh, 64);
+
+    const int64_t totncells = (int64_t) nmesh_x * (int64_t) nmesh_y * (int64_t) nmesh_z;
+    cell_ordering_key *keys = my_malloc(sizeof(*keys), totncells);
+    int64_t *order = my_malloc(sizeof(*order), totncells);
+    if(keys == NULL || order == NULL) {
+        free(keys);free(order);
+        return EXIT_FAILURE;
+    }
+
+    for(int ix=0;ix<nmesh_x;ix++) {
+        for(int iy=0;iy<nmesh_y;iy++) {
+            for(int iz=0;iz<nmesh_z;iz++) {
+                const int64_t index = ix*(int64_t) nmesh_y*nmesh_z + iy*(int64_t) nmesh_z + iz;
+                keys[index].key = (ordering == BINNING_ORD_MORTON) ? morton_key_3d(ix, iy, iz, nbits):hilbert_key_3d(ix, iy, iz, nbits);
+                keys[index].index = index;
+            }
+        }
+    }
+
+    /* Keys are unique -> the rank along the curve is the new cell index. When the lattice is not
+       a cube of size 2^nbits, the curve simply skips over the (non-existent) cells outside the lattice */
+    qsort(keys, totncells, sizeof(*keys), compare_cell_ordering_keys);
+    for(int64_t i=0;i<totncells;i++) {
+        order[keys[i].index] = i;
+    }
+    free(keys);
+
+    *cell_order = order;
+    return EXIT_SUCCESS;
+}
+
+/* Returns the 1-D index of the cell (ix, iy, iz). `cell_order' is the table from get_cell_ordering_table */
+static inline int64_t get_ordered_cell_index(const int ix, const int iy, const int iz, const int nmesh_y, const int nmesh_z,
+                                             const int64_t *cell_order)
+{
+    const int64_t index = ix*(int64_t) nmesh_y*nmesh_z + iy*(int64_t) nmesh_z + iz;
+    return (cell_order == NULL) ? index:cell_order[index];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,28 +19,25 @@ double NS;
 int active_cosmology=-1;
 int cosmology_initialized=0;
 
-int init_cosmology(const int which_cosmology)
+int get_cosmology_params(const int which_cosmology, cosmology_params *params)
 {
-
     switch(which_cosmology)
         {
         case 1:
             //LasDamas Cosmology
-            OMEGA_M=0.25;
-            OMEGA_B=0.04;
-            OMEGA_L=1.0-OMEGA_M;
-            LITTLE_H=0.7;
-            SIGMA_8=0.8;
-            NS=1.0;
+            params->OMEGA_M=0.25;
+            params->OMEGA_B=0.04;
+            params->LITTLE_H=0.7;
+            params->SIGMA_8=0.8;
+            params->NS=1.0;
             break;
         case 2:
             //Planck cosmology
-            OMEGA_M=0.302;
-            OMEGA_B=0.048;
-            OMEGA_L=1.0-OMEGA_M;
-            LITTLE_H=0.681;
-            SIGMA_8=0.828;
-            NS=0.96;
+            params->OMEGA_M=0.302;
+            params->OMEGA_B=0.048;
+            params->LITTLE_H=0.681;
+            params->SIGMA_8=0.828;
+            params->NS=0.96;
             break;
 
         default:
@@ -48,8 +45,26 @@ int init_cosmology(const int which_cosmology)
             return EXIT_FAILURE;
         }
 
+    params->OMEGA_L=1.0-params->OMEGA_M;
+    params->HUBBLE=100.0*params->LITTLE_H;
+    return EXIT_SUCCESS;
+}
+
+int init_cosmology(const int which_cosmology)
+{
+    cosmology_params params;
+    if(get_cosmology_params(which_cosmology, &params) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    OMEGA_M=params.OMEGA_M;
+    OMEGA_B=params.OMEGA_B;
+    OMEGA_L=params.OMEGA_L;
+    HUBBLE=params.HUBBLE;
+    LITTLE_H=params.LITTLE_H;
+    SIGMA_8=params.SIGMA_8;
+    NS=params.NS;
     cosmology_initialized=1;
-    HUBBLE=100.0*LITTLE_H;
     active_cosmology=which_cosmology;
     return EXIT_SUCCESS;
 }
@@ -25,6 +25,19 @@ extern "C" {
 
     int init_cosmology(const int lasdamas_cosmology)__attribute__((warn_unused_result));
 
+    /* The parameters of a cosmology (as in init_cosmology), without the globals above -> for concurrent computations */
+    typedef struct{
+        double OMEGA_M;
+        double OMEGA_B;
+        double OMEGA_L;
+        double HUBBLE;
+        double LITTLE_H;
+        double SIGMA_8;
+        double NS;
+    } cosmology_params;
+
+    int get_cosmology_params(const int which_cosmology, cosmology_params *params)__attribute__((warn_unused_result));
+
 #ifdef __cplusplus
 }
 #endif
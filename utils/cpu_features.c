@@ -10,13 +10,9 @@
 
 #include "cpu_features.h"
 
-int instrset_detect(void)
+static int instrset_detect_cpuid(void)
 {
-    static int iset = -1;                                  // remember value for next call
-    if (iset >= 0) {
-        return iset;                                       // called before
-    }
-    iset = 0;                                              // default value
+    int iset = 0;                                          // default value
     int abcd[4] = {0,0,0,0};                               // cpuid results
     cpuid(abcd, 0);                                        // call cpuid function 0
     if (abcd[0] == 0) return iset;                         // no further cpuid function supported
@@ -51,3 +47,12 @@ int instrset_detect(void)
     return iset;
 }
 
+int instrset_detect(void)
+{
+    /* The value is only stored once it is complete -> concurrent first calls all return the same (final) value */
+    static volatile int iset = -1;                         // remember value for next call
+    if (iset < 0) {
+        iset = instrset_detect_cpuid();
+    }
+    return iset;
+}
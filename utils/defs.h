@@ -44,10 +44,30 @@ the ``uint32_t binning_flags`` */
     
 #define BINNING_REF_MASK         0x0000000F //Last 4 bits for how the bin sizes are calculated is done. Also indicates if refines are in place
 #define BINNING_ORD_MASK         0x000000F0 //Next 4 bits for how the 3-D-> 1-D index conversion
-/* The upper 24 bits are unused currently */
+#define BINNING_NGB_MASK         0x00000F00 //Next 4 bits for how the neighbouring cells are found
+#define BINNING_LAY_MASK         0x000F0000 //Bits 16-19 for how the particles of each cell are laid out in memory
+/* Bits 12-15 and the upper 12 bits are unused currently */
 
 #define BINNING_DFL   0x0
 #define BINNING_CUST  0x1
+
+/* Values for the 3-D -> 1-D cell index conversion (stored in the BINNING_ORD_MASK bits) */
+#define BINNING_ORD_SHIFT     4
+#define BINNING_ORD_ROWMAJOR  0x0 //index = ix*nmesh_y*nmesh_z + iy*nmesh_z + iz
+#define BINNING_ORD_MORTON    0x1 //cells are numbered along a Morton (Z-order) curve
+#define BINNING_ORD_HILBERT   0x2 //cells are numbered along a Hilbert curve
+
+/* Values for finding the neighbouring cells (stored in the BINNING_NGB_MASK bits) */
+#define BINNING_NGB_SHIFT     8
+#define BINNING_NGB_LIST      0x0 //every cell stores pointers to its neighbour cells (and the periodic wraps)
+#define BINNING_NGB_STENCIL   0x1 //neighbour cells are computed on the fly from a shared stencil of cell offsets (see ngb_stencil.h)
+
+/* Values for the memory layout of the particles in each cell (stored in the BINNING_LAY_MASK bits). Used by
+   the lattice for the theory pair-counters; the kernels only read the nelements particles of every cell -> the
+   counts do not depend on the layout */
+#define BINNING_LAY_SHIFT     16
+#define BINNING_LAY_PACKED    0x0 //the cells are contiguous slices of the particle arrays
+#define BINNING_LAY_PADDED    0x1 //every cell starts on a CELL_PAD_BYTES boundary and is padded with sentinels (see cellarray.h)
     
 struct api_cell_timings
 {
@@ -60,6 +80,8 @@ struct api_cell_timings
 };
     
 
+struct exec_context;//see exec_context.h
+
 #define OPTIONS_HEADER_SIZE     (1024)
 struct config_options
 {
@@ -96,6 +118,14 @@ struct config_options
        and time spent to compute the pairs. Might slow down code */
     struct api_cell_timings *cell_timings;
     int64_t totncells_timings;
+
+    /* Largest memory footprint (in bytes) for the particles and the lattice. 0 implies no limit. Otherwise,
+       DD, DDrppi and wp grid and count the box one z-slab at a time (see particle_source.h). */
+    uint64_t memory_budget;
+
+    /* The state of the computation: cancellation, signal handling and the instruction set of the kernels that ran.
+       NULL -> a private state for every call (see exec_context.h) */
+    struct exec_context *context;
     
     
     size_t float_type; /* floating point type -> vectorized supports double/float; fallback can support long double*/
@@ -127,6 +157,19 @@ struct config_options
     /* Fast arccos for wtheta (effective only when OUTPUT_THETAAVG is enabled) */
     uint8_t fast_acos;
 
+    /* Replace the lattice with a kd-tree (dual-tree walk). Used by DD, DDrppi, DDrppi_mocks and DDtheta_mocks */
+    uint8_t use_kdtree;
+
+    /* With float_type == sizeof(float): the <rp>/<theta> and the weight sums are moved into double totals
+       after every cell (positions, distances and the per cell sums stay in float). Lifts the DOUBLE_PREC
+       requirement of OUTPUT_RPAVG/OUTPUT_THETAAVG. No effect for double precision */
+    uint8_t mixed_precision;
+
+    /* With the default binning (BINNING_DFL), DD, DDrppi, wp and xi take the bin refine factors, max_cells_per_dim
+       and instruction set tuned for this machine from an on-disk cache, and tune them on a subsample of the
+       catalog on a miss (see autotune.h) */
+    uint8_t autotune;
+
 
     int8_t bin_refine_factors[3];/* Array for the custom bin refine factors in each dim 
                                    xyz for theory routines and ra/dec/cz for mocks
@@ -147,7 +190,8 @@ struct config_options
     /* Note that the math here assumes no padding bytes, that's because of the 
        order in which the fields are declared (largest to smallest alignments)  */
     uint8_t reserved[OPTIONS_HEADER_SIZE - 33*sizeof(char) - sizeof(size_t) - 9*sizeof(double) - 3*sizeof(int)
-                     - sizeof(uint16_t) - 14*sizeof(uint8_t) - sizeof(struct api_cell_timings *) - sizeof(int64_t) ];
+                     - sizeof(uint16_t) - 17*sizeof(uint8_t) - sizeof(struct api_cell_timings *) - sizeof(int64_t) - sizeof(uint64_t)
+                     - sizeof(struct exec_context *) ];
 };
 
 static inline void set_bin_refine_scheme(struct config_options *options, const int8_t flag)
@@ -169,6 +213,39 @@ static inline int8_t get_bin_refine_scheme(struct config_options *options)
     return (int8_t) (options->binning_flags & BINNING_REF_MASK);
 }
     
+static inline void set_cell_ordering(struct config_options *options, const int8_t flag)
+{
+    //Only touch the 4 bits reserved for the 3-D -> 1-D index conversion
+    options->binning_flags = (options->binning_flags & ~BINNING_ORD_MASK) | ((((uint32_t) flag) << BINNING_ORD_SHIFT) & BINNING_ORD_MASK);
+}
+
+static inline int8_t get_cell_ordering(const struct config_options *options)
+{
+    return (int8_t) ((options->binning_flags & BINNING_ORD_MASK) >> BINNING_ORD_SHIFT);
+}
+
+static inline void set_ngb_scheme(struct config_options *options, const int8_t flag)
+{
+    //Only touch the 4 bits reserved for finding the neighbouring cells
+    options->binning_flags = (options->binning_flags & ~BINNING_NGB_MASK) | ((((uint32_t) flag) << BINNING_NGB_SHIFT) & BINNING_NGB_MASK);
+}
+
+static inline int8_t get_ngb_scheme(const struct config_options *options)
+{
+    return (int8_t) ((options->binning_flags & BINNING_NGB_MASK) >> BINNING_NGB_SHIFT);
+}
+
+static inline void set_cell_layout(struct config_options *options, const int8_t flag)
+{
+    //Only touch the 4 bits reserved for the memory layout of the cells
+    options->binning_flags = (options->binning_flags & ~BINNING_LAY_MASK) | ((((uint32_t) flag) << BINNING_LAY_SHIFT) & BINNING_LAY_MASK);
+}
+
+static inline int8_t get_cell_layout(const struct config_options *options)
+{
+    return (int8_t) ((options->binning_flags & BINNING_LAY_MASK) >> BINNING_LAY_SHIFT);
+}
+
 static inline void set_bin_refine_factors(struct config_options *options, const int bin_refine_factors[3])
 {
     for(int i=0;i<3;i++) {
@@ -254,7 +331,13 @@ static inline struct config_options get_config_options(void)
     options.periodic = 1;
 #endif    
 
-#ifdef __AVX__
+#ifdef MEMORY_BUDGET
+    options.memory_budget = MEMORY_BUDGET;
+#endif
+
+#if defined(__AVX512F__)
+    options.instruction_set = AVX512F;
+#elif defined(__AVX__)
     options.instruction_set = AVX;
 #elif defined(__SSE4_2__)
     options.instruction_set = SSE42;
@@ -287,6 +370,14 @@ static inline struct config_options get_config_options(void)
     options.fast_acos=1;
 #endif    
 
+#ifdef MIXED_PREC
+    options.mixed_precision=1;
+#endif
+
+#ifdef AUTOTUNE
+    options.autotune=1;
+#endif
+
 #ifdef COMOVING_DIST
     options.is_comoving_dist=1;
 #endif
@@ -312,19 +403,50 @@ typedef struct
 {
     void *weights[MAX_NUM_WEIGHTS];  // This will be of shape weights[num_weights][num_particles]
     int64_t num_weights;
+    // weights[0, num_integer_weights) are bitmasks (INVERSE_BITWISE): integers of the same width as the
+    // floating point type (int64_t for doubles, int32_t for floats), stored bit-for-bit in the weight arrays
+    int64_t num_integer_weights;
 } weight_struct;
 
 typedef enum {
   NONE=-42, /* default */
   PAIR_PRODUCT=0,
+  INVERSE_BITWISE=1,
+  SEPARATION_TABLE=2,
   NUM_WEIGHT_TYPE 
 } weight_method_t; // type of weighting to apply
 
+#define MAX_NUM_SEP_WEIGHTS 128
+
+/* Parameters of the weighting methods beyond PAIR_PRODUCT (see weight_functions.h.src):
+
+   INVERSE_BITWISE (the PIP weights): nrealizations / (noffset + the number of bits set in both bitmasks of the pair,
+   summed over the num_integer_weights bitmasks), times the product of the remaining (floating point) weights of the
+   pair, times the separation-dependent factor (e.g., the angular upweighting) if num_sep > 0.
+
+   SEPARATION_TABLE: the product of the first weights of the pair, times the separation-dependent factor.
+
+   The separation-dependent factor is linearly interpolated between the (sep[i], sep_weight[i]), and is 1 outside
+   [sep[0], sep[num_sep-1]]. The separation is the 3-D separation for the theory statistics, and the angle (in
+   degrees) between the two particles for the mocks (DDrppi_mocks and DDtheta_mocks) -> interpolated in cos(angle).
+ */
+typedef struct
+{
+    int64_t num_sep;             // at most MAX_NUM_SEP_WEIGHTS
+    const double *sep;           // increasing
+    const double *sep_weight;
+    double nrealizations;        // 0 -> noffset + the number of bits in the bitmasks
+    double default_value;        // the weight of a pair with a zero denominator
+    int32_t noffset;
+} pair_weight_struct;
+
 /* Gives the number of weight arrays required by the given weighting method
  */
 static inline int get_num_weights_by_method(const weight_method_t method){
     switch(method){
         case PAIR_PRODUCT:
+        case INVERSE_BITWISE:
+        case SEPARATION_TABLE:
             return 1;
         default:
         case NONE:
@@ -346,6 +468,14 @@ static inline int get_weight_method_by_name(const char *name, weight_method_t *m
         *method = PAIR_PRODUCT;
         return EXIT_SUCCESS;
     }
+    if(strcmp(name, "inverse_bitwise") == 0 || strcmp(name, "pip") == 0){
+        *method = INVERSE_BITWISE;
+        return EXIT_SUCCESS;
+    }
+    if(strcmp(name, "separation_table") == 0){
+        *method = SEPARATION_TABLE;
+        return EXIT_SUCCESS;
+    }
         
     return EXIT_FAILURE;
 }
@@ -355,8 +485,14 @@ struct extra_options
     // Two possible weight_structs (at most we will have two loaded sets of particles)
     weight_struct weights0;
     weight_struct weights1;
+    pair_weight_struct pair_weight; // the parameters of INVERSE_BITWISE and SEPARATION_TABLE
     weight_method_t weight_method; // the function that will get called to give the weight of a particle pair
-    uint8_t reserved[EXTRA_OPTIONS_HEADER_SIZE - 2*sizeof(weight_struct) - sizeof(weight_method_t)];
+    // Optional region labels (0 <= label < nregions, e.g., the jackknife regions) for the two sets of particles.
+    // The pair counts are then also returned for every pair of regions (see region_labels.h)
+    int32_t nregions;
+    const int32_t *regions0;
+    const int32_t *regions1;
+    uint8_t reserved[EXTRA_OPTIONS_HEADER_SIZE - 2*sizeof(weight_struct) - sizeof(weight_method_t) - sizeof(pair_weight_struct) - sizeof(int32_t) - 2*sizeof(int32_t *)];
 };
 
 // weight_method determines the number of various weighting arrays that we allocate
@@ -372,6 +508,9 @@ static inline struct extra_options get_extra_options(const weight_method_t weigh
     weight_struct *w1 = &(extra.weights1);
     w0->num_weights = get_num_weights_by_method(extra.weight_method);
     w1->num_weights = w0->num_weights;
+    // All the weights are bitmasks, unless set otherwise
+    w0->num_integer_weights = weight_method == INVERSE_BITWISE ? w0->num_weights:0;
+    w1->num_integer_weights = w0->num_integer_weights;
 
     return extra;
 }
@@ -0,0 +1,124 @@
+/* File: exec_context.c */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "exec_context.h"
+
+/* The signals are the only process-wide state: whether a signal was received while the handlers were installed, and
+   the number of computations that use the handlers (the handlers are installed by the first, and the previous ones
+   restored by the last, which also clears the flag). The lock protects the installation */
+static volatile sig_atomic_t exec_signal_received = 0;
+static int exec_signal_users = 0;
+static int exec_signal_lock = 0;
+
+static const int exec_signals[] = {SIGTERM, SIGINT, SIGHUP};
+#define NUM_EXEC_SIGNALS   ((int) (sizeof(exec_signals)/sizeof(exec_signals[0])))
+
+typedef void (* sig_handlers)(int);
+static sig_handlers exec_previous_handlers[NUM_EXEC_SIGNALS];
+
+/* Only async-signal-safe calls here -> the flag is set, and the message is written with write(2) */
+static void interrupt_handler_exec_context(int signo)
+{
+    static const char msg_int[] = "Received signal = `SIGINT'. Aborting \n";
+    static const char msg_term[] = "Received signal = `SIGTERM'. Aborting \n";
+    static const char msg_hup[] = "Received signal = `SIGHUP'. Aborting \n";
+    const char *msg = signo == SIGINT ? msg_int:(signo == SIGTERM ? msg_term:msg_hup);
+    const size_t len = signo == SIGINT ? sizeof(msg_int):(signo == SIGTERM ? sizeof(msg_term):sizeof(msg_hup));
+    exec_signal_received = 1;
+    const ssize_t nwritten = write(STDERR_FILENO, msg, len - 1);
+    (void) nwritten;
+}
+
+static void lock_signals(void)
+{
+    while(__sync_lock_test_and_set(&exec_signal_lock, 1)) {
+        ;
+    }
+}
+
+static void unlock_signals(void)
+{
+    __sync_lock_release(&exec_signal_lock);
+}
+
+static void install_interrupt_handlers(void)
+{
+    lock_signals();
+    if(exec_signal_users++ == 0) {
+        for(int i=0;i<NUM_EXEC_SIGNALS;i++) {
+            const int signo = exec_signals[i];
+            sig_handlers prev = signal(signo, interrupt_handler_exec_context);
+            if (prev == SIG_ERR) {
+                fprintf(stderr,"Can not handle signal = %d\n", signo);
+            } else if(prev == SIG_IGN) {
+                /* The signal is ignored (e.g., nohup) -> keep it that way */
+                signal(signo, SIG_IGN);
+            }
+            exec_previous_handlers[i] = prev;
+        }
+    }
+    unlock_signals();
+}
+
+static void reset_interrupt_handlers(void)
+{
+    lock_signals();
+    if(--exec_signal_users == 0) {
+        for(int i=0;i<NUM_EXEC_SIGNALS;i++) {
+            const int signo = exec_signals[i];
+            sig_handlers prev = exec_previous_handlers[i];
+            if(prev == SIG_IGN || prev == SIG_ERR) continue;
+            if(signal(signo, prev) == SIG_ERR) {
+                fprintf(stderr,"Could not reset signal handler to default for signal = %d\n", signo);
+            }
+        }
+        /* The signal has aborted every computation that was using the handlers */
+        exec_signal_received = 0;
+    }
+    unlock_signals();
+}
+
+struct exec_context *begin_exec_context(const struct config_options *options, struct exec_context *local_context)
+{
+    struct exec_context *context = options->context;
+    if(context == NULL) {
+        /* mostly useful during the python execution -> Ctrl-C aborts the extension */
+        *local_context = get_exec_context();
+        local_context->handle_signals = 1;
+        context = local_context;
+    }
+
+    context->depth++;
+    if(context->handle_signals) {
+        install_interrupt_handlers();
+    }
+
+    return context;
+}
+
+void end_exec_context(struct exec_context *context)
+{
+    if(context->handle_signals) {
+        reset_interrupt_handlers();
+    }
+    context->depth--;
+}
+
+int exec_context_cancelled(const struct exec_context *context)
+{
+    if(context->cancel) {
+        return 1;
+    }
+    return context->handle_signals && exec_signal_received;
+}
@@ -0,0 +1,69 @@
+/* File: exec_context.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <signal.h>
+
+#include "defs.h"//for struct config_options
+#include "progressbar.h"//for progressbar_state
+
+    /* The state of one computation (a call to one of the statistics), in place of static and global variables ->
+       several computations may run at the same time, from different threads, as long as they do not share a context
+       or a prepared catalog (the catalog caches its neighbour lists, see prepared_catalog.h).
+
+       Set options->context to a context (from get_exec_context) to cancel the computation from another thread, to
+       choose whether SIGINT/SIGTERM/SIGHUP abort it, and to find the instruction set of the kernels that ran. A
+       context is used by one computation at a time. Without a context (options->context == NULL, the default), every
+       computation has a private one, with the signal handling of earlier versions (Ctrl-C aborts the computation).
+
+       The signal handlers are process-wide: they are installed when the first computation with handle_signals starts,
+       and the previous handlers are restored when the last one finishes. The handler only sets a flag, and a signal
+       aborts all of them (including the ones that start before the last one has finished).
+     */
+    struct exec_context
+    {
+        progressbar_state progressbar;
+        volatile int32_t cancel; /* non-zero -> the computation stops (at the next cell) and returns EXIT_FAILURE */
+        int32_t handle_signals; /* SIGINT, SIGTERM and SIGHUP abort the computation */
+        int32_t instruction_set; /* set by the computation: the instruction set of the kernels that ran */
+
+        /* internal */
+        int32_t depth; /* the number of (nested) begin_exec_context */
+    };
+
+    static inline struct exec_context get_exec_context(void)
+    {
+        struct exec_context context;
+        memset(&context, 0, sizeof(context));
+        context.instruction_set = -1;
+        return context;
+    }
+
+    /* options->context, or local_context (with the signal handling of earlier versions) if NULL. Installs the signal
+       handlers with handle_signals. Every begin_exec_context must be matched with an end_exec_context */
+    extern struct exec_context *begin_exec_context(const struct config_options *options, struct exec_context *local_context);
+    extern void end_exec_context(struct exec_context *context);
+
+    /* Has the computation been cancelled (or received a signal, with handle_signals)? */
+    extern int exec_context_cancelled(const struct exec_context *context);
+
+    /* Cancels the computation -> may be called from any thread */
+    static inline void cancel_exec_context(struct exec_context *context)
+    {
+        context->cancel = 1;
+    }
+
+#ifdef __cplusplus
+}
+#endif
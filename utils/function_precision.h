@@ -70,6 +70,9 @@ extern "C" {
 #define ASIN   asin
 #define POW    pow
 #define ABS    fabs
+//integer of the same width as DOUBLE -> the bitmask weights (INVERSE_BITWISE) are stored in the weight arrays
+#define BITMASK          uint64_t
+#define POPCOUNT(X)      __builtin_popcountll(X)
 #else
 #define DOUBLE float
 #define REAL_FORMAT "f"
@@ -86,6 +89,8 @@ extern "C" {
 #define ASIN   asinf
 #define POW    powf
 #define ABS    fabsf
+#define BITMASK          uint32_t
+#define POPCOUNT(X)      __builtin_popcount(X)
 #endif
 
 #ifdef __cplusplus
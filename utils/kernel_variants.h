@@ -0,0 +1,103 @@
+/* File: kernel_variants.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Specialised variants of the pair-counting kernels.
+
+  A kernel is written once, as a body (KERNEL_VARIANT_BODY) that takes
+  four extra arguments: need_rpavg, the weighting method, same_cell and
+  periodic (the offsets of the second cell are non-zero). The kernel that
+  the impls call keeps its usual arguments and only calls the body through
+  DISPATCH_KERNEL_VARIANT, which passes those four as constants -> each
+  combination is compiled into its own copy of the body, in which the tests
+  on the four are folded away and the weight function (pair_weight in
+  weight_functions.h.src) is inlined instead of called through a pointer.
+  A counts-only kernel then has no branch on rpavg/weights left in the
+  j-loop.
+
+  same_cell and the offsets change with the cell pair -> the variant is
+  picked on every call of the kernel, which is once per cell pair and not
+  per particle. Every variant adds to the compile time of the kernels
+  (18 copies of each body).
+
+  need_rpavg and the weighting method are fixed for a whole call of the
+  API. The DD and wp kernels are therefore instead defined as a table of
+  kernels (DEFINE_KERNEL_VARIANT_TABLE), one for every need_rpavg and
+  weighting method, and their drivers resolve the entry once
+  (KERNEL_VARIANT_INDEX) -> the cell loop calls a kernel that only picks
+  among the three cell-pair variants.
+
+  Every pair counter (theory and mocks) calls its kernels this way. The
+  mocks have no periodic images -> they pass 0 for periodic and their
+  bodies ignore it.
+*/
+
+#pragma once
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
+/* The body must be inlined into every variant, otherwise there is only one (generic) copy */
+#define KERNEL_VARIANT_BODY static inline __attribute__((always_inline))
+#else
+#define KERNEL_VARIANT_BODY static inline
+#endif
+
+/* The offsets of the second cell are not all zero (the periodic variants), without tripping -Wfloat-equal */
+#define KERNEL_VARIANT_NONZERO_OFFSETS(X, Y, Z)  ((X) < 0 || (X) > 0 || (Y) < 0 || (Y) > 0 || (Z) < 0 || (Z) > 0)
+
+/* BODY(args..., need_rpavg, weight_method, same_cell, periodic) with the four as constants. The weighting methods
+   other than PAIR_PRODUCT (INVERSE_BITWISE, SEPARATION_TABLE) share one set of variants, in which the method is not
+   a constant -> the switch in pair_weight is taken once per vector of pairs, which is cheap next to those weights */
+#define DISPATCH_KERNEL_VARIANT(BODY, NEED_RPAVG, WEIGHT_METHOD, SAME_CELL, PERIODIC, ...)                       \
+    ((NEED_RPAVG) ? KERNEL_VARIANT_WEIGHTS_(BODY, 1, WEIGHT_METHOD, SAME_CELL, PERIODIC, __VA_ARGS__)          \
+                  : KERNEL_VARIANT_WEIGHTS_(BODY, 0, WEIGHT_METHOD, SAME_CELL, PERIODIC, __VA_ARGS__))
+
+#define KERNEL_VARIANT_WEIGHTS_(BODY, NEED_RPAVG, WEIGHT_METHOD, SAME_CELL, PERIODIC, ...)                       \
+    ((WEIGHT_METHOD) == PAIR_PRODUCT ? KERNEL_VARIANT_CELL_PAIR_(BODY, NEED_RPAVG, PAIR_PRODUCT, SAME_CELL, PERIODIC, __VA_ARGS__) \
+     : (WEIGHT_METHOD) == NONE ? KERNEL_VARIANT_CELL_PAIR_(BODY, NEED_RPAVG, NONE, SAME_CELL, PERIODIC, __VA_ARGS__)       \
+                               : KERNEL_VARIANT_CELL_PAIR_(BODY, NEED_RPAVG, WEIGHT_METHOD, SAME_CELL, PERIODIC, __VA_ARGS__))
+
+/* The same-cell variant adds the offsets (always zero from the impls, a cell is not paired with its own periodic
+   image) -> three variants for the cell pair instead of four */
+#define KERNEL_VARIANT_CELL_PAIR_(BODY, NEED_RPAVG, WEIGHT_METHOD, SAME_CELL, PERIODIC, ...)                     \
+    ((SAME_CELL) ? BODY(__VA_ARGS__, NEED_RPAVG, WEIGHT_METHOD, 1, 1)                                          \
+                 : (PERIODIC) ? BODY(__VA_ARGS__, NEED_RPAVG, WEIGHT_METHOD, 0, 1)                             \
+                              : BODY(__VA_ARGS__, NEED_RPAVG, WEIGHT_METHOD, 0, 0))
+
+/* The entries of a table from DEFINE_KERNEL_VARIANT_TABLE: need_rpavg x {NONE, PAIR_PRODUCT, the other methods} */
+#define NUM_KERNEL_VARIANTS  6
+#define KERNEL_VARIANT_INDEX(NEED_RPAVG, WEIGHT_METHOD)                                                          \
+    (3*((NEED_RPAVG) ? 1:0) + ((WEIGHT_METHOD) == NONE ? 0:((WEIGHT_METHOD) == PAIR_PRODUCT ? 1:2)))
+
+#define KERNEL_VARIANT_PASTE_(NAME, SUFFIX)   KERNEL_VARIANT_PASTE__(NAME, SUFFIX)
+#define KERNEL_VARIANT_PASTE__(NAME, SUFFIX)  NAME##SUFFIX
+
+/* The kernel NAME##SUFFIX: BODY with need_rpavg and the weighting method fixed, which only picks the cell-pair
+   variant. PARAMS is the (parenthesised) parameter list of the kernel and must name same_cell, off_xwrap, off_ywrap,
+   off_zwrap and weight_method; the variadic arguments are the arguments of BODY before the four constants */
+#define DEFINE_KERNEL_VARIANT_(NAME, SUFFIX, BODY, NEED_RPAVG, WEIGHT_METHOD, PARAMS, ...)                       \
+    static int KERNEL_VARIANT_PASTE_(NAME, SUFFIX) PARAMS                                                       \
+    {                                                                                                          \
+        (void) weight_method;                                                                                  \
+        return KERNEL_VARIANT_CELL_PAIR_(BODY, NEED_RPAVG, WEIGHT_METHOD, same_cell,                           \
+                                         KERNEL_VARIANT_NONZERO_OFFSETS(off_xwrap, off_ywrap, off_zwrap), __VA_ARGS__); \
+    }
+
+/* The six kernels of BODY and the table NAME##_variants (of FUNC_PTR_TYPE) of them, in the order of
+   KERNEL_VARIANT_INDEX. The other weighting methods pass weight_method on to pair_weight, as in DISPATCH_KERNEL_VARIANT */
+#define DEFINE_KERNEL_VARIANT_TABLE(NAME, FUNC_PTR_TYPE, BODY, PARAMS, ...)                                      \
+    DEFINE_KERNEL_VARIANT_(NAME, _counts, BODY, 0, NONE, PARAMS, __VA_ARGS__)                                   \
+    DEFINE_KERNEL_VARIANT_(NAME, _pair_product, BODY, 0, PAIR_PRODUCT, PARAMS, __VA_ARGS__)                     \
+    DEFINE_KERNEL_VARIANT_(NAME, _weights, BODY, 0, weight_method, PARAMS, __VA_ARGS__)                         \
+    DEFINE_KERNEL_VARIANT_(NAME, _rpavg_counts, BODY, 1, NONE, PARAMS, __VA_ARGS__)                             \
+    DEFINE_KERNEL_VARIANT_(NAME, _rpavg_pair_product, BODY, 1, PAIR_PRODUCT, PARAMS, __VA_ARGS__)               \
+    DEFINE_KERNEL_VARIANT_(NAME, _rpavg_weights, BODY, 1, weight_method, PARAMS, __VA_ARGS__)                   \
+    static const FUNC_PTR_TYPE KERNEL_VARIANT_PASTE_(NAME, _variants)[NUM_KERNEL_VARIANTS] = {                  \
+        KERNEL_VARIANT_PASTE_(NAME, _counts), KERNEL_VARIANT_PASTE_(NAME, _pair_product),                      \
+        KERNEL_VARIANT_PASTE_(NAME, _weights), KERNEL_VARIANT_PASTE_(NAME, _rpavg_counts),                     \
+        KERNEL_VARIANT_PASTE_(NAME, _rpavg_pair_product), KERNEL_VARIANT_PASTE_(NAME, _rpavg_weights)          \
+    };
@@ -0,0 +1,143 @@
+/* File: ngb_stencil.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Neighbour cells from a stencil (BINNING_NGB_STENCIL in the BINNING_NGB_MASK
+  bits of options->binning_flags).
+
+  By default, every non-empty cell stores the list of pointers to its
+  neighbour cells (ngb_cells) and, for periodic boxes, the wrap offsets
+  (xwrap/ywrap/zwrap) for every neighbour. With the stencil, the same list of
+  (dx, dy, dz) cell offsets is shared by all the cells, and the neighbour
+  cells and the periodic wraps are computed on the fly while counting. The
+  neighbours are visited in the same order as in the stored lists, so the
+  results are identical.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "defs.h"
+#include "utils.h"
+#include "cell_ordering.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct{
+    int dx, dy, dz;
+} ngb_stencil_offset;
+
+typedef struct{
+    int64_t nstencil;
+    ngb_stencil_offset *offsets;
+    int nmesh_x, nmesh_y, nmesh_z;
+    int periodic;
+    int autocorr;/* only the neighbours located before the cell in the lattice are visited */
+    const int64_t *cell_order;/* row-major cell index -> location in the lattice. NULL for the row-major ordering */
+    int64_t *cell_index;/* location in the lattice -> row-major cell index. NULL for the row-major ordering */
+} ngb_stencil;
+
+static inline void free_ngb_stencil(ngb_stencil *stencil)
+{
+    free(stencil->offsets);
+    free(stencil->cell_index);
+    stencil->offsets = NULL;
+    stencil->cell_index = NULL;
+    stencil->nstencil = 0;
+}
+
+/* `cell_order' is the table from get_cell_ordering_table and must remain valid while the stencil is in use */
+static inline int init_ngb_stencil(ngb_stencil *stencil,
+                                   const int xbin_refine_factor, const int ybin_refine_factor, const int zbin_refine_factor,
+                                   const int nmesh_x, const int nmesh_y, const int nmesh_z,
+                                   const int autocorr, const int periodic, const int64_t *cell_order)
+{
+    const int64_t nstencil = (2*xbin_refine_factor + 1) * (int64_t) (2*ybin_refine_factor + 1) * (2*zbin_refine_factor + 1);
+    const int64_t totncells = (int64_t) nmesh_x * (int64_t) nmesh_y * (int64_t) nmesh_z;
+
+    stencil->nstencil = nstencil;
+    stencil->nmesh_x = nmesh_x;
+    stencil->nmesh_y = nmesh_y;
+    stencil->nmesh_z = nmesh_z;
+    stencil->periodic = periodic;
+    stencil->autocorr = autocorr;
+    stencil->cell_order = cell_order;
+    stencil->cell_index = NULL;
+    stencil->offsets = my_malloc(sizeof(*(stencil->offsets)), nstencil);
+    if(stencil->offsets == NULL) {
+        return EXIT_FAILURE;
+    }
+    if(cell_order != NULL) {
+        stencil->cell_index = my_malloc(sizeof(*(stencil->cell_index)), totncells);
+        if(stencil->cell_index == NULL) {
+            free_ngb_stencil(stencil);
+            return EXIT_FAILURE;
+        }
+        for(int64_t index=0;index<totncells;index++) {
+            stencil->cell_index[cell_order[index]] = index;
+        }
+    }
+
+    /* Same order as the loops in assign_ngb_cells_index_particles */
+    int64_t ngb = 0;
+    for(int iix=-xbin_refine_factor;iix<=xbin_refine_factor;iix++){
+        for(int iiy=-ybin_refine_factor;iiy<=ybin_refine_factor;iiy++) {
+            for(int iiz=-zbin_refine_factor;iiz<=zbin_refine_factor;iiz++){
+                stencil->offsets[ngb].dx = iix;
+                stencil->offsets[ngb].dy = iiy;
+                stencil->offsets[ngb].dz = iiz;
+                ngb++;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* 3-D index of the cell at location `icell' in the lattice */
+static inline void get_ngb_stencil_cell_coords(const ngb_stencil *stencil, const int64_t icell, int *ix, int *iy, int *iz)
+{
+    const int64_t index = (stencil->cell_index == NULL) ? icell:stencil->cell_index[icell];
+    *iz = (int) (index % stencil->nmesh_z);
+    *iy = (int) ((index / stencil->nmesh_z) % stencil->nmesh_y);
+    *ix = (int) (index / ((int64_t) stencil->nmesh_y * stencil->nmesh_z));
+}
+
+/* Returns the location in the lattice of the ngb'th stencil neighbour of the cell at location `icell' (and 3-D index ix, iy, iz),
+   or -1 if that neighbour should not be visited. wrap[] is set to the multiple (-1, 0 or +1) of the periodic wrapping length
+   along each axis -> i.e., the off_xwrap/off_ywrap/off_zwrap for the pair of cells are wrap[0]*xdiff, wrap[1]*ydiff, wrap[2]*zdiff */
+static inline int64_t get_ngb_stencil_cell(const ngb_stencil *stencil, const int ix, const int iy, const int iz, const int64_t icell,
+                                           const int64_t ngb, int wrap[3])
+{
+    const ngb_stencil_offset *off = &(stencil->offsets[ngb]);
+    int jj[3] = {ix + off->dx, iy + off->dy, iz + off->dz};
+    const int nmesh[3] = {stencil->nmesh_x, stencil->nmesh_y, stencil->nmesh_z};
+    for(int i=0;i<3;i++) {
+        wrap[i] = 0;
+        if(jj[i] >= 0 && jj[i] < nmesh[i]) continue;
+        if(stencil->periodic != 1) {
+            return -1;
+        }
+        wrap[i] = (jj[i] < 0) ? 1:-1;
+        jj[i] = (jj[i] + nmesh[i]) % nmesh[i];
+    }
+    const int64_t icell2 = get_ordered_cell_index(jj[0], jj[1], jj[2], stencil->nmesh_y, stencil->nmesh_z, stencil->cell_order);
+    if(stencil->autocorr == 1 && icell2 >= icell) {
+        return -1;
+    }
+    return icell2;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,108 @@
+/* File: particle_source.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Sequential access to a set of particles for the memory-budgeted (z-slab)
+  pair counting in DD, DDrppi and wp (options->memory_budget > 0).
+
+  The particles are read in chunks, and every pass over the particles starts
+  from the first particle. The pair-counters make a few passes to find the
+  bounds and the occupancy of the z-cells of the lattice, and then one pass
+  for every slab of z-cells (and its halo). Only the particles of the current
+  slab (plus the halo) are ever held in memory - so the particles can come
+  straight from a file (see open_particle_source in io.h) or from arrays that
+  are already in memory (init_particle_source_arrays below).
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "defs.h"//for weight_struct
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+    typedef struct particle_source particle_source;
+    struct particle_source{
+        int64_t np;
+        int num_weights;
+        size_t float_type;/* sizeof(float) or sizeof(double) -> precision of the values returned by read */
+
+        /* Copies the particles [start, start + n) into x, y, z and weights[0...num_weights-1]. Each
+           array has room for n values. Returns EXIT_SUCCESS or EXIT_FAILURE */
+        int (*read)(particle_source *source, const int64_t start, const int64_t n, void *x, void *y, void *z, void **weights);
+        void (*close)(particle_source *source);/* releases `state'. May be NULL */
+        void *state;
+    };
+
+    static inline void close_particle_source(particle_source *source)
+    {
+        if(source->close != NULL) {
+            source->close(source);
+        }
+        source->state = NULL;
+    }
+
+    /* Particles that are already in memory */
+    typedef struct{
+        const char *x, *y, *z;
+        const char *weights[MAX_NUM_WEIGHTS];
+    } particle_source_arrays;
+
+    static inline int read_particle_source_arrays(particle_source *source, const int64_t start, const int64_t n,
+                                                  void *x, void *y, void *z, void **weights)
+    {
+        const particle_source_arrays *arrays = (const particle_source_arrays *) source->state;
+        const size_t offset = start * source->float_type;
+        const size_t bytes = n * source->float_type;
+        memcpy(x, arrays->x + offset, bytes);
+        memcpy(y, arrays->y + offset, bytes);
+        memcpy(z, arrays->z + offset, bytes);
+        for(int w=0;w<source->num_weights;w++) {
+            memcpy(weights[w], arrays->weights[w] + offset, bytes);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    static inline void close_particle_source_arrays(particle_source *source)
+    {
+        free(source->state);
+    }
+
+    /* The arrays are not copied and must remain valid while the source is in use. `weights' may be NULL */
+    static inline int init_particle_source_arrays(particle_source *source, const int64_t np,
+                                                  const void *x, const void *y, const void *z, const weight_struct *weights,
+                                                  const size_t float_type)
+    {
+        particle_source_arrays *arrays = (particle_source_arrays *) calloc(1, sizeof(*arrays));
+        if(arrays == NULL) {
+            fprintf(stderr,"Error: In %s> Could not allocate memory for the particle source\n", __FUNCTION__);
+            return EXIT_FAILURE;
+        }
+        arrays->x = (const char *) x;
+        arrays->y = (const char *) y;
+        arrays->z = (const char *) z;
+        source->num_weights = (weights == NULL) ? 0 : (int) weights->num_weights;
+        for(int w=0;w<source->num_weights;w++) {
+            arrays->weights[w] = (const char *) weights->weights[w];
+        }
+        source->np = np;
+        source->float_type = float_type;
+        source->read = read_particle_source_arrays;
+        source->close = close_particle_source_arrays;
+        source->state = arrays;
+        return EXIT_SUCCESS;
+    }
+
+#ifdef __cplusplus
+}
+#endif
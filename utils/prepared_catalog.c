@@ -0,0 +1,91 @@
+/* File: prepared_catalog.c */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "prepared_catalog.h" //function proto-type for API
+#include "gridlink_impl_double.h"//actual implementations for double
+#include "gridlink_impl_float.h"//actual implementations for float
+
+
+int prepare_catalog(const int64_t np, void * restrict X, void * restrict Y, void * restrict Z,
+                    const double rmax, const double pimax,
+                    const double *bounds,
+                    const int numthreads,
+                    prepared_catalog *catalog,
+                    struct config_options *options,
+                    struct extra_options *extra)
+{
+    if( ! (options->float_type == sizeof(float) || options->float_type == sizeof(double))){
+        fprintf(stderr,"ERROR: In %s> Can only handle doubles or floats. Got an array of size = %zu\n",
+                __FUNCTION__, options->float_type);
+        return EXIT_FAILURE;
+    }
+
+    if( strncmp(options->version, STR(VERSION), sizeof(options->version)/sizeof(char)-1) != 0) {
+        fprintf(stderr,"Error: Do not know this API version = `%s'. Expected version = `%s'\n", options->version, STR(VERSION));
+        return EXIT_FAILURE;
+    }
+
+    if(options->float_type == sizeof(float)) {
+        return prepare_catalog_float(np, (float * restrict) X, (float * restrict) Y, (float * restrict) Z,
+                                     rmax, pimax,
+                                     bounds,
+                                     numthreads,
+                                     catalog,
+                                     options,
+                                     extra);
+    } else {
+        return prepare_catalog_double(np, (double * restrict) X, (double * restrict) Y, (double * restrict) Z,
+                                      rmax, pimax,
+                                      bounds,
+                                      numthreads,
+                                      catalog,
+                                      options,
+                                      extra);
+    }
+}
+
+
+int update_prepared_catalog(prepared_catalog *catalog,
+                            const int64_t ninsert, void *X, void *Y, void *Z, const weight_struct *weights,
+                            const int64_t nremove, void *RX, void *RY, void *RZ)
+{
+    if(catalog == NULL || catalog->catalog == NULL) {
+        fprintf(stderr,"ERROR: In %s> Need a prepared catalog to update\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    if(catalog->float_type == sizeof(float)) {
+        return update_catalog_float(catalog,
+                                    ninsert, (float *) X, (float *) Y, (float *) Z, weights,
+                                    nremove, (float *) RX, (float *) RY, (float *) RZ);
+    } else {
+        return update_catalog_double(catalog,
+                                     ninsert, (double *) X, (double *) Y, (double *) Z, weights,
+                                     nremove, (double *) RX, (double *) RY, (double *) RZ);
+    }
+}
+
+
+void free_prepared_catalog(prepared_catalog *catalog)
+{
+    if(catalog == NULL)
+        return;
+
+    if(catalog->float_type == sizeof(float)) {
+        free_prepared_catalog_float(catalog->catalog);
+    } else {
+        free_prepared_catalog_double(catalog->catalog);
+    }
+    catalog->catalog = NULL;
+    catalog->np = 0;
+}
@@ -0,0 +1,76 @@
+/* File: prepared_catalog.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "defs.h"//for struct config_options and struct extra_options
+#include <stdint.h>
+
+    /* A catalog that has already been gridded (and sorted in z) and can be
+       re-used across calls to the theory pair-counters (DD, DDrppi, wp and xi).
+       The catalog keeps its own copy of the particles, so the input arrays can
+       be released once the catalog has been prepared.
+
+       The neighbour lists for the last pairing the catalog was used in are
+       cached within the catalog -> a catalog must not be used by two
+       pair-counting calls at the same time (even from separate execution
+       contexts, see exec_context.h), nor updated while it is being used.
+     */
+    typedef struct{
+        size_t float_type;/* sizeof(float) or sizeof(double) */
+        int64_t np;
+        int nmesh[3];
+        int bin_refine_factors[3];
+        double rmax;/* largest separation (along x and y) that can be counted with this catalog */
+        double pimax;/* largest separation along z that can be counted with this catalog */
+        void *catalog;/* prepared_catalog_float * or prepared_catalog_double * */
+    } prepared_catalog;
+
+    /* Grid the particles so that pairs up to separation `rmax' in x/y and `pimax' in z can be counted.
+       For DD and xi, use pimax == rmax.
+
+       `bounds' is either NULL or an array of 6 elements: [xmin, xmax, ymin, ymax, zmin, zmax].
+       If NULL, the bounds are [0, boxsize] in periodic mode (with boxsize > 0) and the
+       min/max of the particle positions otherwise. Two catalogs can be cross-correlated
+       only if they were prepared with identical bounds (and grids).
+
+       Weights are taken from extra->weights0 (if extra is not NULL), and the region labels
+       from extra->regions0 (see region_labels.h). Catalogs with region labels can only be
+       counted with DD and DDrppi.
+     */
+    extern int prepare_catalog(const int64_t np, void *X, void *Y, void *Z,
+                               const double rmax, const double pimax,
+                               const double *bounds,
+                               const int numthreads,
+                               prepared_catalog *catalog,
+                               struct config_options *options,
+                               struct extra_options *extra) __attribute__((warn_unused_result));
+
+    /* Inserts `ninsert' particles (X, Y, Z, with `weights' that may be NULL for a catalog without weights) into the
+       catalog and removes the `nremove' particles at exactly the positions (RX, RY, RZ). The new particles must lie
+       within the bounds of the catalog.
+
+       Only the cells that change are updated (and kept sorted in z), so the cost scales with the number of
+       particles that change rather than with the size of the catalog. The exception is a cell that runs out
+       of room, when all the cells are moved into a larger buffer (with room for ~20% more particles per cell).
+       Catalogs gridded as a kd-tree (options->use_kdtree), or with region labels, can not be updated. The catalog is left unchanged
+       on failure.
+     */
+    extern int update_prepared_catalog(prepared_catalog *catalog,
+                                       const int64_t ninsert, void *X, void *Y, void *Z, const weight_struct *weights,
+                                       const int64_t nremove, void *RX, void *RY, void *RZ) __attribute__((warn_unused_result));
+
+    extern void free_prepared_catalog(prepared_catalog *catalog);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,93 +10,82 @@
 #include "utils.h"
 #include <inttypes.h>
 
-#ifndef MAXLEN
-#define MAXLEN 1000
-#endif
-
-
-static double SMALLPRINTSTEP;
-static char PROGRESSBARSTRING[MAXLEN];
-static int beg_of_string_index;
-static double percent=0;
-static int END_INDEX_FOR_PERCENT_DONE[101];
-struct timeval tstart;
-
-void init_my_progressbar(const int64_t N,int *interrupted)
+void init_my_progressbar(progressbar_state *bar, const int64_t N,int *interrupted)
 {
     int index=0;
     if(N <= 0) {
         fprintf(stderr,"WARNING: N=%"PRId64" is not positive. Progress bar will not be printed\n",N);
-        SMALLPRINTSTEP = 0.0;
+        bar->SMALLPRINTSTEP = 0.0;
     } else {
         //set the increment
-        SMALLPRINTSTEP = 0.01 * N;
+        bar->SMALLPRINTSTEP = 0.01 * N;
 
         //pre-fill the progress bar string
         //first the 0%
         index=0;
-        my_snprintf(&(PROGRESSBARSTRING[index]),MAXLEN-index,"%s","0%");
+        my_snprintf(&(bar->PROGRESSBARSTRING[index]),PROGRESSBAR_MAXLEN-index,"%s","0%");
         index+=2;
-        END_INDEX_FOR_PERCENT_DONE[0] = index;
+        bar->END_INDEX_FOR_PERCENT_DONE[0] = index;
         for(int i=1;i<100;i++) {
             if(i%10 == 0) {
-                my_snprintf(&(PROGRESSBARSTRING[index]),MAXLEN-index,"%02d%%",i);
+                my_snprintf(&(bar->PROGRESSBARSTRING[index]),PROGRESSBAR_MAXLEN-index,"%02d%%",i);
                 index += 3;
             } else {
-                PROGRESSBARSTRING[index++] = '.';
+                bar->PROGRESSBARSTRING[index++] = '.';
             }
-            END_INDEX_FOR_PERCENT_DONE[i] = index;
+            bar->END_INDEX_FOR_PERCENT_DONE[i] = index;
         }
 
         //end with 100%
-        my_snprintf(&(PROGRESSBARSTRING[index]),MAXLEN-index,"%s","100%");
+        my_snprintf(&(bar->PROGRESSBARSTRING[index]),PROGRESSBAR_MAXLEN-index,"%s","100%");
         index+=4;
-        END_INDEX_FOR_PERCENT_DONE[100] = index;
-        PROGRESSBARSTRING[index+1] = '\0';
+        bar->END_INDEX_FOR_PERCENT_DONE[100] = index;
+        bar->PROGRESSBARSTRING[index+1] = '\0';
 
     }
     *interrupted=0;
-    beg_of_string_index=0;
-    gettimeofday(&tstart, NULL);
+    bar->percent=0;
+    bar->beg_of_string_index=0;
+    gettimeofday(&bar->tstart, NULL);
 }
 
-void my_progressbar(const int64_t curr_index,int *interrupted)
+void my_progressbar(progressbar_state *bar, const int64_t curr_index,int *interrupted)
 {
     int integer_percent=0;
-    if(SMALLPRINTSTEP > 0.0 )   {
+    if(bar->SMALLPRINTSTEP > 0.0 )   {
       if(*interrupted == 1) {
         fprintf(stderr,"\n");
         *interrupted = 0;
-        beg_of_string_index = 0;
+        bar->beg_of_string_index = 0;
       }
       
-      percent = (curr_index+1)/SMALLPRINTSTEP;//division is in double -> C has 0-based indexing -- the +1 accounts for that.
-      integer_percent = (int) percent;
+      bar->percent = (curr_index+1)/bar->SMALLPRINTSTEP;//division is in double -> C has 0-based indexing -- the +1 accounts for that.
+      integer_percent = (int) bar->percent;
       
       if (integer_percent >= 0 && integer_percent <= 100)  {
-        /*        for(int i=beg_of_string_index;i<END_INDEX_FOR_PERCENT_DONE[integer_percent];i++) */
-        /*            fprintf(stderr,"%c",PROGRESSBARSTRING[i]); */
+        /*        for(int i=bar->beg_of_string_index;i<bar->END_INDEX_FOR_PERCENT_DONE[integer_percent];i++) */
+        /*            fprintf(stderr,"%c",bar->PROGRESSBARSTRING[i]); */
         
-        fprintf(stderr,"%.*s",END_INDEX_FOR_PERCENT_DONE[integer_percent]-beg_of_string_index,&(PROGRESSBARSTRING[beg_of_string_index]));
-        beg_of_string_index = END_INDEX_FOR_PERCENT_DONE[integer_percent];
+        fprintf(stderr,"%.*s",bar->END_INDEX_FOR_PERCENT_DONE[integer_percent]-bar->beg_of_string_index,&(bar->PROGRESSBARSTRING[bar->beg_of_string_index]));
+        bar->beg_of_string_index = bar->END_INDEX_FOR_PERCENT_DONE[integer_percent];
       }
     }
 }
 
-void finish_myprogressbar(int *interrupted)
+void finish_myprogressbar(progressbar_state *bar, int *interrupted)
 {
   struct timeval t1;
   gettimeofday(&t1, NULL);
-  char * time_string = get_time_string(tstart, t1);
-  if(SMALLPRINTSTEP > 0.0) {
+  char * time_string = get_time_string(bar->tstart, t1);
+  if(bar->SMALLPRINTSTEP > 0.0) {
     if(*interrupted == 0)   {
-      if(percent < 100.0) {
+      if(bar->percent < 100.0) {
         fprintf(stderr,"100%% done.");
       } else {
         fprintf(stderr," done.");
       }
     } else {
-      fprintf(stderr,"\n%s done.",PROGRESSBARSTRING);
+      fprintf(stderr,"\n%s done.",bar->PROGRESSBARSTRING);
       *interrupted=0;
     }
   } else {
@@ -105,6 +94,6 @@ void finish_myprogressbar(int *interrupted)
   fprintf(stderr," Time taken = %s\n", time_string);
   free(time_string);
   
-  beg_of_string_index = 0;
-  my_snprintf(PROGRESSBARSTRING,MAXLEN,"%s"," ");
+  bar->beg_of_string_index = 0;
+  my_snprintf(bar->PROGRESSBARSTRING,PROGRESSBAR_MAXLEN,"%s"," ");
 }
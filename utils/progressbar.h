@@ -12,15 +12,27 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/time.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define PROGRESSBAR_MAXLEN    1000
 
-    void init_my_progressbar(const int64_t N,int *interrupted);
-    void my_progressbar(const int64_t curr_index,int *interrupted);
-    void finish_myprogressbar(int *interrupted);
+    /* The state of one progressbar (one per computation, see exec_context.h) */
+    typedef struct{
+        double SMALLPRINTSTEP;
+        double percent;
+        struct timeval tstart;
+        int beg_of_string_index;
+        int END_INDEX_FOR_PERCENT_DONE[101];
+        char PROGRESSBARSTRING[PROGRESSBAR_MAXLEN];
+    } progressbar_state;
+
+    void init_my_progressbar(progressbar_state *bar, const int64_t N,int *interrupted);
+    void my_progressbar(progressbar_state *bar, const int64_t curr_index,int *interrupted);
+    void finish_myprogressbar(progressbar_state *bar, int *interrupted);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,142 @@
+/* File: region_labels.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Pair counts split by region label (e.g., the jackknife regions), for DD,
+  DDrppi, DDrppi_mocks and DDtheta_mocks.
+
+  Every particle carries an integer label, 0 <= label < nregions (see
+  extra_options->regions0/regions1). The labels are carried through gridlink
+  into the cells, where the particles are grouped by label (and sorted on
+  z/cz within each group). The kernels then run once for every pair of
+  groups in a pair of cells and add the pairs to the histogram for that
+  pair of regions -> all the pair counts come out of a single pass:
+
+    region_npairs[(i*nregions + j)*nbin + k] = number of pairs in bin k with
+                                               the first particle in region i
+                                               and the second particle in region j
+
+  (the same bin index k as in results->npairs -> nbin is (nrpbin+1)*(npibin+1)
+  for DDrppi and DDrppi_mocks). For autocorrelations, every
+  pair is counted in both orders -> the matrix is symmetric and sums to
+  results->npairs. The leave-one-out (jackknife) and the bootstrap pair
+  counts follow from the matrix, with the functions below.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Checks that every label is within [0, nregions) */
+static inline int check_region_labels(const int64_t np, const int32_t *regions, const int32_t nregions)
+{
+    if(nregions <= 0) {
+        fprintf(stderr,"Error: In %s> Need a positive number of regions. Found nregions = %d\n", __FUNCTION__, nregions);
+        return EXIT_FAILURE;
+    }
+    if(regions == NULL) {
+        fprintf(stderr,"Error: In %s> Found nregions = %d but no region labels\n", __FUNCTION__, nregions);
+        return EXIT_FAILURE;
+    }
+    for(int64_t i=0;i<np;i++) {
+        if(regions[i] < 0 || regions[i] >= nregions) {
+            fprintf(stderr,"Error: In %s> Particle %"PRId64" has region label %d. The labels must be within [0, %d)\n",
+                    __FUNCTION__, i, regions[i], nregions);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* One past the last particle, at or after `start', in the run of particles with the same label as particle `start' */
+static inline int64_t get_region_run_end(const int32_t *regions, const int64_t start, const int64_t n)
+{
+    const int32_t label = regions[start];
+    int64_t end = start + 1;
+    while(end < n && regions[end] == label) {
+        end++;
+    }
+    return end;
+}
+
+/* The autocorrelations only count every (unordered) pair once, in region (i, j) or (j, i) depending on the
+   order in which the cells are visited. Adds the two -> the counts of the ordered pairs, as in results->npairs */
+static inline void symmetrize_region_npairs(const int32_t nregions, const int nbin, uint64_t *region_npairs)
+{
+    for(int32_t i=0;i<nregions;i++) {
+        for(int32_t j=i;j<nregions;j++) {
+            uint64_t *ij = region_npairs + ((int64_t) i*nregions + j)*nbin;
+            uint64_t *ji = region_npairs + ((int64_t) j*nregions + i)*nbin;
+            for(int k=0;k<nbin;k++) {
+                const uint64_t sum = ij[k] + ji[k];
+                ij[k] = sum;
+                ji[k] = sum;
+            }
+        }
+    }
+}
+
+/* Pair counts with each region left out in turn (the jackknife samples):
+   jackknife_npairs[r*nbin + k] = sum over the (i, j) with i != r and j != r of region_npairs[(i*nregions + j)*nbin + k] */
+static inline void get_jackknife_npairs(const int32_t nregions, const int nbin, const uint64_t *region_npairs, uint64_t *jackknife_npairs)
+{
+    uint64_t total[nbin];
+    for(int k=0;k<nbin;k++) {
+        total[k] = 0;
+    }
+    for(int64_t ij=0;ij<(int64_t) nregions*nregions;ij++) {
+        for(int k=0;k<nbin;k++) {
+            total[k] += region_npairs[ij*nbin + k];
+        }
+    }
+
+    for(int32_t r=0;r<nregions;r++) {
+        uint64_t *dst = jackknife_npairs + (int64_t) r*nbin;
+        for(int k=0;k<nbin;k++) {
+            dst[k] = total[k] + region_npairs[((int64_t) r*nregions + r)*nbin + k];
+        }
+        for(int32_t i=0;i<nregions;i++) {
+            const uint64_t *row = region_npairs + ((int64_t) r*nregions + i)*nbin;
+            const uint64_t *col = region_npairs + ((int64_t) i*nregions + r)*nbin;
+            for(int k=0;k<nbin;k++) {
+                dst[k] -= row[k] + col[k];
+            }
+        }
+    }
+}
+
+/* Pair counts for a bootstrap sample where region i is drawn multiplicity[i] times:
+   bootstrap_npairs[k] = sum over (i, j) of multiplicity[i]*multiplicity[j]*region_npairs[(i*nregions + j)*nbin + k] */
+static inline void get_bootstrap_npairs(const int32_t nregions, const int nbin, const uint64_t *region_npairs,
+                                        const int32_t *multiplicity, uint64_t *bootstrap_npairs)
+{
+    for(int k=0;k<nbin;k++) {
+        bootstrap_npairs[k] = 0;
+    }
+    for(int32_t i=0;i<nregions;i++) {
+        for(int32_t j=0;j<nregions;j++) {
+            const uint64_t fac = (uint64_t) multiplicity[i] * (uint64_t) multiplicity[j];
+            if(fac == 0) continue;
+            const uint64_t *ij = region_npairs + ((int64_t) i*nregions + j)*nbin;
+            for(int k=0;k<nbin;k++) {
+                bootstrap_npairs[k] += fac*ij[k];
+            }
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,8 +26,9 @@
 
 int set_cosmo_dist(const double zmax,const int max_size,double *zc,double *dc,const int lasdamas_cosmology)
 {
-    /* First, initialize cosmology*/
-    int status = init_cosmology(lasdamas_cosmology);
+    /* First, get the cosmology (not the globals in cosmology_params.c -> may be called concurrently) */
+    cosmology_params cosmo;
+    int status = get_cosmology_params(lasdamas_cosmology, &cosmo);
     if(status != EXIT_SUCCESS) {
         return -1;
     }
@@ -38,7 +39,7 @@ int set_cosmo_dist(const double zmax,const int max_size,double *zc,double *dc,co
     double Eint,E0,E1,E2,Dh,Dc;
     double smallh = 1.0;//Andreas pointed out that I don't need the real value of LITTLE_H
     /* double one_plus_z,one_plus_z_minus_dz,one_plus_z_sqr,one_plus_z_minus_dz_sqr; */
-    Omegak = 1.0 - OMEGA_M - OMEGA_L;
+    Omegak = 1.0 - cosmo.OMEGA_M - cosmo.OMEGA_L;
     Dh = SPEED_OF_LIGHT*0.01/smallh ;// c/(100) -> in units of little h^-1 Mpc
 
     Deltaz = 1.0/max_size;
@@ -50,8 +51,8 @@ int set_cosmo_dist(const double zmax,const int max_size,double *zc,double *dc,co
     for(z=2.*dz;z<zmax;z+=2.*dz) {
         E0 = E2 ;
 
-        E1 = 1.0/sqrt(OMEGA_M * CUBE(1+z-dz) + Omegak *(1+z-dz) + OMEGA_L);
-        E2 = 1.0/sqrt(OMEGA_M * CUBE(1+z) + Omegak *(1+z) + OMEGA_L);
+        E1 = 1.0/sqrt(cosmo.OMEGA_M * CUBE(1+z-dz) + Omegak *(1+z-dz) + cosmo.OMEGA_L);
+        E2 = 1.0/sqrt(cosmo.OMEGA_M * CUBE(1+z) + Omegak *(1+z) + cosmo.OMEGA_L);
         Eint += dz*(E0 + 4.*E1 + E2)/3. ;
 
 
@@ -68,7 +69,7 @@ int set_cosmo_dist(const double zmax,const int max_size,double *zc,double *dc,co
     }
 
 #ifdef DEBUG
-    fprintf(stderr,"cosmodist> (Omega_m, Omega_L, Omega_k, h, zmax) = (%4.2f, %4.2f, %4.2f, %4.2f,%4.2lf)\n",OMEGA_M,OMEGA_L,Omegak,LITTLE_H,zmax) ;
+    fprintf(stderr,"cosmodist> (Omega_m, Omega_L, Omega_k, h, zmax) = (%4.2f, %4.2f, %4.2f, %4.2f,%4.2lf)\n",cosmo.OMEGA_M,cosmo.OMEGA_L,Omegak,cosmo.LITTLE_H,zmax) ;
     fprintf(stderr,"cosmodist> tabulated redshift: %g to %g  (distance: %g to %g Mpc)\n", zc[0], zc[i-1], dc[0], dc[i-1]) ;
 #endif
     return i ;
@@ -0,0 +1,164 @@
+/* File: simd_calls.h */
+/*
+  This file is a part of the Corrfunc package
+  Copyright (C) 2015-- Manodeep Sinha (manodeep@gmail.com)
+  License: MIT LICENSE. See LICENSE file under the top-level
+  directory at https://github.com/manodeep/Corrfunc/
+*/
+
+/*
+  Width-generic vector layer (SIMD_*) over avx512_calls.h, avx_calls.h and
+  sse_calls.h, for kernels that are written once for every instruction set.
+
+  Define SIMD_TARGET (one of the SIMD_TARGET_* below) and include this
+  file, and then the source of the kernel -> the SIMD_* macros are those of
+  that instruction set, and SIMD_NAME gives the kernel the usual name of the
+  variant (e.g., xi_avx512_intrinsics_DOUBLE). The same pair of includes is
+  repeated for every instruction set enabled at compile time; the kernel to
+  run is still picked at runtime by the impls (options->instruction_set, as
+  detected by instrset_detect() in cpu_features.c).
+
+  The masks are the native ones: a bitmask for AVX512F and a vector of
+  comparison results for AVX and SSE. A kernel only uses them through the
+  SIMD_MASK_* macros. The last, partial, vector of a loop is loaded with
+  SIMD_MASKZ_LOAD_FLOATS -> no scalar remainder loop. SIMD_MASK_STORE_FLOATS
+  and SIMD_MASK_COMPRESS_STORE_FLOATS are the stores of the lanes in a mask;
+  AVX512F has both in hardware, AVX has the masked store only and SSE has
+  neither (-> through a small array in avx_calls.h/sse_calls.h).
+
+  This file is included once per target, and therefore has no include guard.
+*/
+
+#include "function_precision.h"
+
+#define SIMD_TARGET_SSE42           1
+#define SIMD_TARGET_AVX             2
+#define SIMD_TARGET_AVX512F         3
+
+#undef SIMD_NVEC
+#undef SIMD_FLOATS
+#undef SIMD_MASK
+#undef SIMD_NAME
+#undef SIMD_HELPER
+#undef SIMD_WEIGHT_MEMBER
+#undef SIMD_SET_FLOAT
+#undef SIMD_SETZERO_FLOAT
+#undef SIMD_ADD_FLOATS
+#undef SIMD_SUBTRACT_FLOATS
+#undef SIMD_SQUARE_FLOAT
+#undef SIMD_SQRT_FLOAT
+#undef SIMD_MASK_FIRST_N
+#undef SIMD_MASKZ_LOAD_FLOATS
+#undef SIMD_MASK_STORE_FLOATS
+#undef SIMD_MASK_COMPRESS_STORE_FLOATS
+#undef SIMD_MASK_COMPARE_LT
+#undef SIMD_MASK_COMPARE_GE
+#undef SIMD_MASK_ANDNOT
+#undef SIMD_MASK_BITS
+#undef SIMD_MASK_BITCOUNT
+#undef SIMD_MASK_ADD_FLOATS
+#undef SIMD_BLEND_FLOATS
+
+#if !defined(SIMD_TARGET)
+#error "Define SIMD_TARGET (one of SIMD_TARGET_SSE42, SIMD_TARGET_AVX or SIMD_TARGET_AVX512F) before including simd_calls.h"
+
+#elif SIMD_TARGET == SIMD_TARGET_AVX512F
+#include "avx512_calls.h"
+
+#define SIMD_NVEC                               AVX512_NVEC
+#define SIMD_FLOATS                             AVX512_FLOATS
+#define SIMD_MASK                               AVX512_MASK
+    // PREFIX_avx512_SUFFIX -> the name of the variant of a kernel
+#define SIMD_NAME(PREFIX,SUFFIX)                PREFIX##_avx512_##SUFFIX
+    // avx512_NAME -> the helpers in bin_lookup.h.src, bin_sums.h.src and weight_functions.h.src
+#define SIMD_HELPER(NAME)                       avx512_##NAME
+    // the member of weight_union_DOUBLE (weight_functions.h.src)
+#define SIMD_WEIGHT_MEMBER                      a512
+
+#define SIMD_SET_FLOAT(X)                       AVX512_SET_FLOAT(X)
+#define SIMD_SETZERO_FLOAT()                    AVX512_SETZERO_FLOAT()
+#define SIMD_ADD_FLOATS(X,Y)                    AVX512_ADD_FLOATS(X,Y)
+#define SIMD_SUBTRACT_FLOATS(X,Y)               AVX512_SUBTRACT_FLOATS(X,Y)
+#define SIMD_SQUARE_FLOAT(X)                    AVX512_SQUARE_FLOAT(X)
+#define SIMD_SQRT_FLOAT(X)                      AVX512_SQRT_FLOAT(X)
+
+    // the first N lanes; X[0, N) for the lanes in MASK (= SIMD_MASK_FIRST_N(N)), zero otherwise
+#define SIMD_MASK_FIRST_N(N)                    avx512_mask_first_n(N)
+#define SIMD_MASKZ_LOAD_FLOATS(MASK,N,X)        AVX512_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)
+    // Y -> X[k] for the lanes k in MASK, the other elements of X are not written
+#define SIMD_MASK_STORE_FLOATS(MASK,X,Y)        AVX512_MASK_STORE_FLOATS_TO_MEMORY(X,MASK,Y)
+    // the lanes of Y in MASK -> X[0, n), and evaluates to n (the number of lanes in MASK)
+#define SIMD_MASK_COMPRESS_STORE_FLOATS(MASK,X,Y) (AVX512_MASK_COMPRESS_STORE_FLOATS(X,MASK,Y), (int) AVX512_MASK_BITCOUNT(MASK))
+    // the lanes of MASK with X < Y (X >= Y)
+#define SIMD_MASK_COMPARE_LT(MASK,X,Y)          AVX512_MASK_COMPARE_FLOATS(MASK,X,Y,_CMP_LT_OS)
+#define SIMD_MASK_COMPARE_GE(MASK,X,Y)          AVX512_MASK_COMPARE_FLOATS(MASK,X,Y,_CMP_GE_OS)
+    // the lanes of MASK that are not in X
+#define SIMD_MASK_ANDNOT(MASK,X)                ((SIMD_MASK) ((MASK) & ~(X)))
+    // one bit per lane, and the number of lanes set
+#define SIMD_MASK_BITS(MASK)                    ((unsigned int) (MASK))
+#define SIMD_MASK_BITCOUNT(MASK)                AVX512_MASK_BITCOUNT(MASK)
+    // SUM + X for the lanes in MASK, SUM otherwise
+#define SIMD_MASK_ADD_FLOATS(SUM,MASK,X)        AVX512_MASK_ADD_FLOATS(SUM,MASK,SUM,X)
+#define SIMD_BLEND_FLOATS(MASK,FALSEVALUE,TRUEVALUE) AVX512_BLEND_FLOATS_WITH_MASK(MASK,FALSEVALUE,TRUEVALUE)
+
+#elif SIMD_TARGET == SIMD_TARGET_AVX
+#include "avx_calls.h"
+
+#define SIMD_NVEC                               AVX_NVEC
+#define SIMD_FLOATS                             AVX_FLOATS
+#define SIMD_MASK                               AVX_FLOATS
+#define SIMD_NAME(PREFIX,SUFFIX)                PREFIX##_avx_##SUFFIX
+#define SIMD_HELPER(NAME)                       avx_##NAME
+#define SIMD_WEIGHT_MEMBER                      a
+
+#define SIMD_SET_FLOAT(X)                       AVX_SET_FLOAT(X)
+#define SIMD_SETZERO_FLOAT()                    AVX_SET_FLOAT((DOUBLE) 0)
+#define SIMD_ADD_FLOATS(X,Y)                    AVX_ADD_FLOATS(X,Y)
+#define SIMD_SUBTRACT_FLOATS(X,Y)               AVX_SUBTRACT_FLOATS(X,Y)
+#define SIMD_SQUARE_FLOAT(X)                    AVX_SQUARE_FLOAT(X)
+#define SIMD_SQRT_FLOAT(X)                      AVX_SQRT_FLOAT(X)
+
+#define SIMD_MASK_FIRST_N(N)                    avx_mask_first_n(N)
+#define SIMD_MASKZ_LOAD_FLOATS(MASK,N,X)        AVX_MASKZ_LOAD_FLOATS_UNALIGNED(MASK,X)
+#define SIMD_MASK_STORE_FLOATS(MASK,X,Y)        AVX_MASKSTORE_FLOATS(X, AVX_CAST_FLOAT_TO_INT(MASK), Y)
+#define SIMD_MASK_COMPRESS_STORE_FLOATS(MASK,X,Y) avx_mask_compress_store(X,MASK,Y)
+#define SIMD_MASK_COMPARE_LT(MASK,X,Y)          AVX_BITWISE_AND(MASK, AVX_COMPARE_FLOATS(X,Y,_CMP_LT_OS))
+#define SIMD_MASK_COMPARE_GE(MASK,X,Y)          AVX_BITWISE_AND(MASK, AVX_COMPARE_FLOATS(X,Y,_CMP_GE_OS))
+#define SIMD_MASK_ANDNOT(MASK,X)                AVX_AND_NOT(X,MASK)
+#define SIMD_MASK_BITS(MASK)                    ((unsigned int) AVX_TEST_COMPARISON(MASK))
+#define SIMD_MASK_BITCOUNT(MASK)                AVX_BIT_COUNT_INT(AVX_TEST_COMPARISON(MASK))
+#define SIMD_MASK_ADD_FLOATS(SUM,MASK,X)        AVX_ADD_FLOATS(SUM, AVX_BITWISE_AND(MASK,X))
+#define SIMD_BLEND_FLOATS(MASK,FALSEVALUE,TRUEVALUE) AVX_BLEND_FLOATS_WITH_MASK(FALSEVALUE,TRUEVALUE,MASK)
+
+#elif SIMD_TARGET == SIMD_TARGET_SSE42
+#include "sse_calls.h"
+
+#define SIMD_NVEC                               SSE_NVEC
+#define SIMD_FLOATS                             SSE_FLOATS
+#define SIMD_MASK                               SSE_FLOATS
+#define SIMD_NAME(PREFIX,SUFFIX)                PREFIX##_sse_##SUFFIX
+#define SIMD_HELPER(NAME)                       sse_##NAME
+#define SIMD_WEIGHT_MEMBER                      s
+
+#define SIMD_SET_FLOAT(X)                       SSE_SET_FLOAT(X)
+#define SIMD_SETZERO_FLOAT()                    SSE_SET_FLOAT((DOUBLE) 0)
+#define SIMD_ADD_FLOATS(X,Y)                    SSE_ADD_FLOATS(X,Y)
+#define SIMD_SUBTRACT_FLOATS(X,Y)               SSE_SUBTRACT_FLOATS(X,Y)
+#define SIMD_SQUARE_FLOAT(X)                    SSE_SQUARE_FLOAT(X)
+#define SIMD_SQRT_FLOAT(X)                      SSE_SQRT_FLOAT(X)
+
+#define SIMD_MASK_FIRST_N(N)                    sse_mask_first_n(N)
+#define SIMD_MASKZ_LOAD_FLOATS(MASK,N,X)        sse_load_first_n(N,X)
+#define SIMD_MASK_STORE_FLOATS(MASK,X,Y)        sse_mask_store(MASK,X,Y)
+#define SIMD_MASK_COMPRESS_STORE_FLOATS(MASK,X,Y) sse_mask_compress_store(X,MASK,Y)
+#define SIMD_MASK_COMPARE_LT(MASK,X,Y)          SSE_BITWISE_AND(MASK, SSE_COMPARE_FLOATS_LT(X,Y))
+#define SIMD_MASK_COMPARE_GE(MASK,X,Y)          SSE_BITWISE_AND(MASK, SSE_COMPARE_FLOATS_GE(X,Y))
+#define SIMD_MASK_ANDNOT(MASK,X)                SSE_AND_NOT(X,MASK)
+#define SIMD_MASK_BITS(MASK)                    ((unsigned int) SSE_TEST_COMPARISON(MASK))
+#define SIMD_MASK_BITCOUNT(MASK)                SSE_BIT_COUNT_INT(SSE_TEST_COMPARISON(MASK))
+#define SIMD_MASK_ADD_FLOATS(SUM,MASK,X)        SSE_ADD_FLOATS(SUM, SSE_BITWISE_AND(MASK,X))
+#define SIMD_BLEND_FLOATS(MASK,FALSEVALUE,TRUEVALUE) SSE_BLEND_FLOATS_WITH_MASK(FALSEVALUE,TRUEVALUE,MASK)
+
+#else
+#error "Unknown SIMD_TARGET -> must be one of SIMD_TARGET_SSE42, SIMD_TARGET_AVX or SIMD_TARGET_AVX512F"
+#endif
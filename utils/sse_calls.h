@@ -38,6 +38,8 @@ extern "C" {
 #define SSE_DIVIDE_FLOATS(X,Y)           _mm_div_ps(X,Y)
 #define SSE_SQRT_FLOAT(X)                _mm_sqrt_ps(X)
 #define SSE_TRUNCATE_FLOAT_TO_INT(X)     _mm_cvttps_epi32(X)
+#define SSE_CONVERT_INT_TO_FLOAT(X)      _mm_cvtepi32_ps(X)
+#define SSE_STORE_FLOATS_TO_MEMORY(X,Y)  _mm_storeu_ps(X,Y)
 #define SSE_SQUARE_FLOAT(X)              _mm_mul_ps(X,X)
 #define SSE_SET_FLOAT(X)                 _mm_set1_ps(X)
 
@@ -45,17 +47,23 @@ extern "C" {
 #define SSE_COMPARE_FLOATS_LT(X,Y)       _mm_cmplt_ps(X,Y)
 #define SSE_COMPARE_FLOATS_LE(X,Y)       _mm_cmple_ps(X,Y)    
 #define SSE_COMPARE_FLOATS_GT(X,Y)       _mm_cmpgt_ps(X,Y)    
+#define SSE_COMPARE_FLOATS_EQ(X,Y)       _mm_cmpeq_ps(X,Y)
 // X OP Y
 //#define SSE_COMPARE_FLOATS(X,Y,OP)        _mm_cmp_ps(X,Y,OP)
 #define SSE_BITWISE_AND(X,Y)              _mm_and_ps(X,Y)
+#define SSE_AND_NOT(X,Y)                  _mm_andnot_ps(X,Y)  //~X & Y
 
 //MoveMask
 #define SSE_TEST_COMPARISON(X)            _mm_movemask_ps(X)
 
 #define SSE_BLEND_FLOATS_WITH_MASK(FALSEVALUE,TRUEVALUE,MASK) _mm_blendv_ps(FALSEVALUE,TRUEVALUE,MASK)
 
-//Max
+//Max and min (the second operand if either is NaN)
 #define SSE_MAX_FLOATS(X,Y)               _mm_max_ps(X,Y)
+#define SSE_MIN_FLOATS(X,Y)               _mm_min_ps(X,Y)
+
+//log2(X) for X > 0 to within 0.09, from the exponent and the (linear) mantissa bits (see bin_lookup.h)
+#define SSE_APPROX_LOG2_FLOAT(X)          _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(X)), _mm_set1_ps(1.0f/8388608.0f)), _mm_set1_ps(127.0f))
 
 #define SSE_ABS_FLOAT(X)                  _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), X), X)
   
@@ -87,6 +95,7 @@ extern "C" {
 
 //Memory stores
 #define SSE_TRUNCATE_FLOAT_TO_INT(X)     _mm_cvttpd_epi32(X)
+#define SSE_CONVERT_INT_TO_FLOAT(X)      _mm_cvtepi32_pd(X)
 #define SSE_STORE_FLOATS_TO_MEMORY(X,Y)  _mm_storeu_pd(X,Y)
 
 //The comparisons
@@ -94,10 +103,12 @@ extern "C" {
 #define SSE_COMPARE_FLOATS_LT(X,Y)       _mm_cmplt_pd(X,Y)
 #define SSE_COMPARE_FLOATS_LE(X,Y)       _mm_cmple_pd(X,Y)    
 #define SSE_COMPARE_FLOATS_GT(X,Y)       _mm_cmpgt_pd(X,Y)    
+#define SSE_COMPARE_FLOATS_EQ(X,Y)       _mm_cmpeq_pd(X,Y)
 
 
 //Bitwise and
 #define SSE_BITWISE_AND(X,Y)              _mm_and_pd(X,Y)
+#define SSE_AND_NOT(X,Y)                  _mm_andnot_pd(X,Y)  //~X & Y
 
 //MoveMask
 #define SSE_TEST_COMPARISON(X)            _mm_movemask_pd(X)
@@ -111,10 +122,64 @@ extern "C" {
 #endif
 
 #define SSE_MAX_FLOATS(X,Y)               _mm_max_pd(X,Y)
+#define SSE_MIN_FLOATS(X,Y)               _mm_min_pd(X,Y)
+//Same as the float version, from the bits of X rounded to float (no 64-bit integer conversions before AVX-512)
+#define SSE_APPROX_LOG2_FLOAT(X)          _mm_cvtps_pd(_mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(_mm_cvtpd_ps(X))), _mm_set1_ps(1.0f/8388608.0f)), _mm_set1_ps(127.0f)))
 #define SSE_ABS_FLOAT(X)                  _mm_max_pd(_mm_sub_pd(_mm_setzero_pd(), X), X)
 
 #endif
 
+/* Comparison mask with the first n (0 <= n) lanes set -> the last, partial, vector */
+static inline SSE_FLOATS sse_mask_first_n(const int64_t n)
+{
+    DOUBLE lanes[SSE_NVEC];
+    for(int jj=0;jj<SSE_NVEC;jj++) {
+        lanes[jj] = (DOUBLE) jj;
+    }
+    return SSE_COMPARE_FLOATS_LT(SSE_LOAD_FLOATS_UNALIGNED(lanes), SSE_SET_FLOAT((DOUBLE) (n < SSE_NVEC ? n:SSE_NVEC)));
+}
+
+/* The first n (0 <= n) elements of X, and zeros in the other lanes -> X[n] onwards is not read (SSE has no masked loads) */
+static inline SSE_FLOATS sse_load_first_n(const int64_t n, const DOUBLE *X)
+{
+    if(n >= SSE_NVEC) {
+        return SSE_LOAD_FLOATS_UNALIGNED(X);
+    }
+    DOUBLE lanes[SSE_NVEC];
+    for(int jj=0;jj<SSE_NVEC;jj++) {
+        lanes[jj] = jj < n ? X[jj]:(DOUBLE) 0;
+    }
+    return SSE_LOAD_FLOATS_UNALIGNED(lanes);
+}
+
+/* Y for the lanes set in MASK (a comparison) -> X; the other elements of X are neither read nor written (SSE has no masked stores) */
+static inline void sse_mask_store(const SSE_FLOATS MASK, DOUBLE *X, const SSE_FLOATS Y)
+{
+    DOUBLE lanes[SSE_NVEC];
+    SSE_STORE_FLOATS_TO_MEMORY(lanes, Y);
+    const int bits = SSE_TEST_COMPARISON(MASK);
+    for(int jj=0;jj<SSE_NVEC;jj++) {
+        if(bits & (1 << jj)) {
+            X[jj] = lanes[jj];
+        }
+    }
+}
+
+/* The lanes of Y set in MASK (a comparison), stored contiguously from X -> the number of lanes stored */
+static inline int sse_mask_compress_store(DOUBLE *X, const SSE_FLOATS MASK, const SSE_FLOATS Y)
+{
+    DOUBLE lanes[SSE_NVEC];
+    SSE_STORE_FLOATS_TO_MEMORY(lanes, Y);
+    const int bits = SSE_TEST_COMPARISON(MASK);
+    int n = 0;
+    for(int jj=0;jj<SSE_NVEC;jj++) {
+        if(bits & (1 << jj)) {
+            X[n++] = lanes[jj];
+        }
+    }
+    return n;
+}
+
 #ifndef  __INTEL_COMPILER
     #include "fast_acos.h"
     static inline SSE_FLOATS inv_cosine_sse(const SSE_FLOATS X, const int order)
@@ -102,6 +102,51 @@ int setup_bins(const char *fname,double *rmin,double *rmax,int *nbin,double **ru
 
 
 
+/* Edge i of (nbin, rupp) is within 0.1% of a bin of x0 + i*dx, with x the edges transformed by (*f) */
+static int bin_edges_are_uniform(const int nbin, const double *rupp, double (*f)(double))
+{
+    const double x0 = f(rupp[0]), dx = (f(rupp[nbin-1]) - x0)/(nbin - 1);
+    if( ! (dx > 0.0)) {
+        return 0;
+    }
+    for(int i=1;i<nbin-1;i++) {
+        if( ! (fabs(f(rupp[i]) - (x0 + i*dx)) <= 1e-3*dx)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static double bin_edge_identity(double x)
+{
+    return x;
+}
+
+static double bin_edge_square(double x)
+{
+    return x*x;
+}
+
+/* Linear, linear in r^2 or logarithmic bin edges (rupp[0...nbin-1], as from setup_bins) -> the
+   pair-counting kernels find the bin of a pair arithmetically instead of searching over the bins */
+bin_spacing_t detect_bin_spacing(const int nbin, const double *rupp)
+{
+    if(nbin < 2 || rupp == NULL) {
+        return BIN_SPACING_ARBITRARY;
+    }
+    if(bin_edges_are_uniform(nbin, rupp, bin_edge_identity)) {
+        return BIN_SPACING_LINEAR;
+    }
+    if(rupp[0] > 0.0 && bin_edges_are_uniform(nbin, rupp, log)) {
+        return BIN_SPACING_LOG;
+    }
+    if(bin_edges_are_uniform(nbin, rupp, bin_edge_square)) {
+        return BIN_SPACING_LINEAR_SQR;
+    }
+    return BIN_SPACING_ARBITRARY;
+}
+
+
 int setup_bins_double(const char *fname,double *rmin,double *rmax,int *nbin,double **rupp)
 {
     //set up the bins according to the binned data file
@@ -505,6 +550,20 @@ void* my_malloc(size_t size,int64_t N)
 
 
 
+/* alignment must be a power of two multiple of sizeof(void *). Released with free() */
+void* my_malloc_aligned(size_t size,int64_t N,size_t alignment)
+{
+    void *x = NULL;
+    const int status = posix_memalign(&x, alignment, N*size);
+    if (status != 0){
+        fprintf(stderr,"aligned malloc for %"PRId64" elements with %zu bytes (alignment = %zu bytes) failed...\n",N,size,alignment);
+        return NULL;
+    }
+
+    return x;
+}
+
+
 void* my_calloc(size_t size,int64_t N)
 {
     void *x = NULL;
@@ -44,6 +44,7 @@ extern void* my_realloc(void *x,size_t size,int64_t N,const char *varname);
 extern void* my_realloc_in_function(void **x,size_t size,int64_t N,const char *varname);
 extern void* my_malloc(size_t size,int64_t N);
 extern void* my_calloc(size_t size,int64_t N);
+extern void* my_malloc_aligned(size_t size,int64_t N,size_t alignment);
 extern void my_free(void ** x);
 extern void **matrix_malloc(size_t size,int64_t nx,int64_t ny);
 extern void **matrix_calloc(size_t size,int64_t nx,int64_t ny);
@@ -60,6 +61,15 @@ extern int setup_bins(const char *fname,double *rmin,double *rmax,int *nbin,doub
 extern int setup_bins_double(const char *fname,double *rmin,double *rmax,int *nbin,double **rupp);
 extern int setup_bins_float(const char *fname,float *rmin,float *rmax,int *nbin,float **rupp);
 
+/* Spacing of the bin edges (see detect_bin_spacing and bin_lookup.h.src) */
+typedef enum {
+  BIN_SPACING_ARBITRARY=0, /* no pattern -> the kernels search over the bins */
+  BIN_SPACING_LINEAR=1, /* uniform in r */
+  BIN_SPACING_LINEAR_SQR=2, /* uniform in r^2 */
+  BIN_SPACING_LOG=3 /* uniform in log(r) */
+} bin_spacing_t;
+extern bin_spacing_t detect_bin_spacing(const int nbin, const double *rupp);
+
 extern int test_all_files_present(const int nfiles, ...);
 
 /* Floating point comparison utilities */